@@ -0,0 +1,598 @@
+/*
+ * This software is available under 2 licenses -- choose whichever you prefer.
+ *
+ * -------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2023 Romain BAILLY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * -------------------------------------------------------------------------------
+ *
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * For more information, please refer to <https://unlicense.org/>
+ */
+
+#include <rmgr/nsfr.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <string>
+#include <vector>
+
+
+using namespace rmgr::nsfr;
+
+
+//=================================================================================================
+// Allocation counting
+
+static std::atomic<size_t> g_allocationCount(0); // Parallel batches allocate from several threads
+
+void* operator new(size_t size)
+{
+    ++g_allocationCount;
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+
+//=================================================================================================
+// Value distributions
+
+/**
+ * @brief Small and fast PRNG (PCG), so that runs are reproducible across platforms
+ */
+struct Random
+{
+    uint64_t state;
+
+    explicit Random(uint64_t seed): state(seed) {}
+
+    uint32_t next32()
+    {
+        state = state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const uint32_t xorShifted = static_cast<uint32_t>(((state >> 18) ^ state) >> 27);
+        const unsigned rotation   = static_cast<unsigned>(state >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+    uint64_t next64()                       {return (uint64_t(next32()) << 32) | next32();}
+    uint64_t between(uint64_t a, uint64_t b) {return a + next64() % (b - a + 1);} ///< Within [a;b]
+};
+
+
+struct Distribution
+{
+    const char* name;
+    uint64_t  (*generate)(Random& random);
+};
+
+static uint64_t uniform32(Random& random) {return random.next32();}
+static uint64_t uniform64(Random& random) {return random.next64();}
+static uint64_t pages(Random& random)     {return random.between(1, 500);}
+static uint64_t years(Random& random)     {return random.between(1900, 2100);}
+static uint64_t ordinals(Random& random)  {return random.between(1, 100);}
+
+/**
+ * @brief Amounts in euros, spread over several orders of magnitude like real invoices
+ */
+static uint64_t invoices(Random& random)
+{
+    static const uint64_t magnitudes[] = {100, 1000, 10000, 100000, 1000000};
+    return random.between(1, magnitudes[random.next32() % (sizeof(magnitudes) / sizeof(magnitudes[0]))]);
+}
+
+
+//=================================================================================================
+// Cases
+
+enum Api
+{
+    API_SPELL_OUT,
+    API_TO_WORDS,
+    API_APPEND_TO,
+    API_PROFILE,
+    API_SPELLED_LENGTH,
+    API_REFERENCE,
+    API_PARSE,
+    API_AMOUNT,
+    API_AMOUNT_BATCH,
+    API_CACHE,
+    API_TOKENS,
+    API_MATCHES,
+    API_COMPLETE,
+    API_COMPARE,
+    API_SORT_KEY
+};
+
+static const char* const g_apiNames[] =
+{
+    "spell_out", "to_words", "append_to", "profile", "spelled_length", "reference", "parse", "amount", "amount_batch", "cache", "tokens", "matches", "complete", "compare_spelled", "sort_key"
+};
+
+
+struct Case
+{
+    const char*         name;
+    const Distribution* distribution;
+    unsigned            options;
+};
+
+static const Distribution g_uniform32 = {"uniform32", uniform32};
+static const Distribution g_uniform64 = {"uniform64", uniform64};
+static const Distribution g_pages     = {"pages",     pages};
+static const Distribution g_invoices  = {"invoices",  invoices};
+static const Distribution g_years     = {"years",     years};
+static const Distribution g_ordinals  = {"ordinals",  ordinals};
+
+static const Case g_cases[] =
+{
+    {"uniform32",             &g_uniform32, CARDINAL},
+    {"uniform64",             &g_uniform64, CARDINAL},
+    {"pages",                 &g_pages,     CARDINAL_AS_ORDINAL},
+    {"invoices",              &g_invoices,  CARDINAL},
+    {"years",                 &g_years,     CARDINAL},
+    {"ordinals",              &g_ordinals,  ORDINAL},
+    {"ordinals_feminine",     &g_ordinals,  ORDINAL | FEMININE},
+    {"invoices_belgium",      &g_invoices,  BELGIUM},
+    {"invoices_switzerland",  &g_invoices,  SWITZERLAND},
+    {"invoices_octante",      &g_invoices,  OCTANTE},
+    {"years_cent_1100_1999",  &g_years,     CENT_1100_1999},
+};
+
+
+//=================================================================================================
+// Measurements
+
+static const size_t VALUE_COUNT = 100000;
+
+struct Result
+{
+    double nsPerCall;
+    double bytesPerSecond;
+    double allocationsPerCall;
+};
+
+
+/**
+ * @brief Runs @p api over all @p values, as many times as needed to last at least @p minSeconds
+ */
+static Result measure(Api api, const std::vector<uint64_t>& values, const std::vector<std::string>& spellings, unsigned options, double minSeconds)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Values are amounts in cents for the amount APIs
+    const std::vector<intmax_t> amounts(values.begin(), values.end());
+    spelled_column              column;
+    spelling_cache              cache;
+    const completion_index      index(options);
+    completions                 completed;
+
+    const profile prof(options);
+    char          buffer[512];
+    token         tokens[internal::MAX_TOKEN_COUNT];
+    std::string   str;
+    size_t        bytes      = 0;
+    size_t        calls      = 0;
+    size_t        checksum   = 0;
+    size_t        allocStart = g_allocationCount;
+    double        elapsed    = 0.0;
+    const Clock::time_point start = Clock::now();
+    do
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const uint64_t value = values[i];
+            switch (api)
+            {
+                case API_SPELL_OUT:
+                    bytes += spell_out(value, options).size();
+                    break;
+                case API_TO_WORDS:
+                    bytes += size_t(to_words(buffer, buffer + sizeof(buffer), value, options).ptr - buffer);
+                    break;
+                case API_APPEND_TO:
+                    str.clear();
+                    append_to(str, value, options);
+                    bytes += str.size();
+                    break;
+                case API_PROFILE:
+                    bytes += size_t(prof.to_words(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+                    break;
+                case API_SPELLED_LENGTH:
+                    bytes += spelled_length(value, options);
+                    break;
+                case API_REFERENCE:
+                    bytes += internal::spell_out_reference(value, options).size();
+                    break;
+                case API_PARSE:
+                {
+                    const std::string& spelling = spellings[i];
+                    checksum += size_t(parse(spelling.data(), spelling.data() + spelling.size()).value);
+                    bytes    += spelling.size();
+                    break;
+                }
+                case API_AMOUNT:
+                    bytes += size_t(to_words_amount(buffer, buffer + sizeof(buffer), amounts[i], EURO, options).ptr - buffer);
+                    break;
+                case API_AMOUNT_BATCH:
+                    // A whole statement column at once, its buffers being reused from one pass to the next
+                    if (i == 0)
+                    {
+                        column.clear();
+                        spell_out_amount_batch(column, amounts.data(), amounts.size(), EURO, options);
+                        bytes += column.byte_size();
+                    }
+                    break;
+                case API_CACHE:
+                    bytes += cache.spell_out(value, options)->size();
+                    break;
+                case API_TOKENS:
+                    bytes += size_t(spell_tokens(value, options, tokens) - tokens);
+                    break;
+                case API_MATCHES:
+                {
+                    const std::string& spelling = spellings[i];
+                    checksum += matches(value, options, spelling.data(), spelling.data() + spelling.size());
+                    bytes    += spelling.size();
+                    break;
+                }
+                case API_COMPLETE:
+                {
+                    // As typed halfway through
+                    const std::string& spelling = spellings[i];
+                    index.lookup(spelling.data(), spelling.data() + spelling.size() / 2u, completed);
+                    checksum += completed.values.size() + completed.words.size();
+                    bytes    += spelling.size() / 2u;
+                    break;
+                }
+                case API_COMPARE:
+                    // Neighbours in the distribution, as a comparison sort would meet them
+                    checksum += size_t(compare_spelled(value, values[(i + 1u) % values.size()], options) + 1);
+                    bytes    += spellings[i].size();
+                    break;
+                case API_SORT_KEY:
+                    checksum += size_t(spelled_sort_key(value, options));
+                    bytes    += spellings[i].size();
+                    break;
+            }
+        }
+        calls  += values.size();
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    while (elapsed < minSeconds);
+
+    if (checksum == 1u) // Prevents the calls from being optimized away
+        puts("");
+
+    Result result;
+    result.nsPerCall          = elapsed * 1e9 / double(calls);
+    result.bytesPerSecond     = double(bytes) / elapsed;
+    result.allocationsPerCall = double(g_allocationCount - allocStart) / double(calls);
+    return result;
+}
+
+
+//=================================================================================================
+// Scaling
+
+static const size_t SCALING_VALUE_COUNT = 2000000;
+
+/**
+ * @brief Measures how parallel batches scale with the number of threads, up to what the hardware runs
+ */
+static void measure_scaling(bool json, double minSeconds)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    Random                random(42);
+    std::vector<uint64_t> values(SCALING_VALUE_COUNT);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = random.next64();
+
+    const unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    spelled_column column;
+    double         baseline = 0.0;
+    bool           first    = true;
+    if (json)
+        printf("{\n  \"scaling\": [");
+    else
+        printf("%-10s %12s %12s %12s\n", "threads", "ns/value", "MB/s", "speedup");
+    for (unsigned threads = 1; ; threads = std::min(2u * threads, maxThreads))
+    {
+        size_t calls   = 0;
+        size_t bytes   = 0;
+        double elapsed = 0.0;
+        const Clock::time_point start = Clock::now();
+        do
+        {
+            column.clear();
+            spell_out_parallel(column, values.data(), values.size(), CARDINAL, threads);
+            calls  += values.size();
+            bytes  += column.byte_size();
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        while (elapsed < minSeconds);
+
+        const double nsPerValue = elapsed * 1e9 / double(calls);
+        if (threads == 1u)
+            baseline = nsPerValue;
+        if (json)
+        {
+            printf("%s\n    {\"threads\": %u, \"ns_per_value\": %.2f, \"bytes_per_second\": %.0f, \"speedup\": %.2f}",
+                   first ? "" : ",", threads, nsPerValue, double(bytes) / elapsed, baseline / nsPerValue);
+        }
+        else
+            printf("%-10u %12.2f %12.1f %12.2f\n", threads, nsPerValue, double(bytes) / elapsed / 1e6, baseline / nsPerValue);
+        first = false;
+
+        if (threads == maxThreads)
+            break;
+    }
+    if (json)
+        printf("\n  ]\n}\n");
+}
+
+
+//=================================================================================================
+// Texts
+
+static const size_t TEXT_SIZE  = 64u << 20;
+static const size_t CHUNK_SIZE = 64u << 10;
+
+static const struct {const char* name; size_t spacing;} g_textDensities[] =
+{
+    {"dense",   16},   // Tables, listings
+    {"prose",   200},  // News, novels
+    {"sparse",  4096}, // Texts where numbers are the exception
+};
+
+
+/**
+ * @brief Makes a text with a number every @p spacing bytes, in digits or spelled out
+ */
+static std::string make_text(size_t spacing, bool spelled)
+{
+    static const char filler[] = "Le chat dort sur le canap\xC3\xA9 pendant que la pluie tombe sur les toits. ";
+
+    Random      random(42);
+    std::string text;
+    text.reserve(TEXT_SIZE + 256u);
+    while (text.size() < TEXT_SIZE)
+    {
+        for (size_t i = 0; i < spacing; ++i)
+            text += filler[(text.size() + i) % (sizeof(filler) - 1u)];
+        text += ' ';
+        const uint64_t value   = random.between(1, 100000);
+        const bool     ordinal = (random.between(0, 4) == 0);
+        if (spelled)
+            append_to(text, value, ordinal ? ORDINAL : CARDINAL);
+        else
+            text += std::to_string(value) + (ordinal ? "e" : "");
+    }
+    return text;
+}
+
+
+static void count_bytes(void* context, const char*, size_t length)
+{
+    *static_cast<size_t*>(context) += length;
+}
+
+
+static void count_number(void* context, const spelled_number&)
+{
+    ++*static_cast<size_t*>(context);
+}
+
+
+/**
+ * @brief Measures the throughput of the normalizer or of the scanner, on texts with fewer and fewer numbers
+ */
+static void measure_text(bool json, double minSeconds, bool scanning)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    if (json)
+        printf("{\n  \"%s\": [", scanning ? "scanning" : "normalization");
+    else
+        printf("%-10s %12s %12s\n", "text", "input MB/s", scanning ? "numbers/s" : "output MB/s");
+    for (size_t d = 0; d < sizeof(g_textDensities) / sizeof(g_textDensities[0]); ++d)
+    {
+        const std::string text = make_text(g_textDensities[d].spacing, scanning);
+
+        size_t inBytes = 0;
+        size_t output  = 0; // Bytes written by the normalizer, numbers found by the scanner
+        double elapsed = 0.0;
+        const Clock::time_point start = Clock::now();
+        do
+        {
+            if (scanning)
+            {
+                scanner reader(count_number, &output);
+                for (size_t i = 0; i < text.size(); i += CHUNK_SIZE)
+                    reader.feed(text.data() + i, std::min(CHUNK_SIZE, text.size() - i));
+                reader.finish();
+            }
+            else
+            {
+                normalizer norm(count_bytes, &output);
+                for (size_t i = 0; i < text.size(); i += CHUNK_SIZE)
+                    norm.feed(text.data() + i, std::min(CHUNK_SIZE, text.size() - i));
+                norm.finish();
+            }
+            inBytes += text.size();
+            elapsed  = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        while (elapsed < minSeconds);
+
+        if (json)
+        {
+            printf("%s\n    {\"text\": \"%s\", \"input_bytes_per_second\": %.0f, \"%s\": %.0f}",
+                   (d == 0u) ? "" : ",", g_textDensities[d].name, double(inBytes) / elapsed,
+                   scanning ? "numbers_per_second" : "output_bytes_per_second", double(output) / elapsed);
+        }
+        else
+        {
+            printf("%-10s %12.1f %12.1f\n", g_textDensities[d].name, double(inBytes) / elapsed / 1e6,
+                   scanning ? double(output) / elapsed : double(output) / elapsed / 1e6);
+        }
+    }
+    if (json)
+        printf("\n  ]\n}\n");
+}
+
+
+static void print_usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--json] [--time SECONDS] [--filter SUBSTRING] [--scaling] [--normalize] [--scan]\n", program);
+}
+
+
+int main(int argc, char* argv[])
+{
+    bool        json       = false;
+    double      minSeconds = 0.2;
+    const char* filter     = nullptr;
+    bool        scaling    = false;
+    bool        normalize  = false;
+    bool        scan       = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+            minSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--scaling") == 0)
+            scaling = true;
+        else if (strcmp(argv[i], "--normalize") == 0)
+            normalize = true;
+        else if (strcmp(argv[i], "--scan") == 0)
+            scan = true;
+        else
+        {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (scaling)
+    {
+        measure_scaling(json, minSeconds);
+        return EXIT_SUCCESS;
+    }
+    if (normalize || scan)
+    {
+        measure_text(json, minSeconds, scan);
+        return EXIT_SUCCESS;
+    }
+
+    if (json)
+        printf("{\n  \"results\": [");
+    else
+        printf("%-22s %-15s %12s %12s %14s\n", "case", "api", "ns/call", "MB/s", "allocs/call");
+
+    bool first = true;
+    for (size_t c = 0; c < sizeof(g_cases) / sizeof(g_cases[0]); ++c)
+    {
+        const Case& benchCase = g_cases[c];
+        if (filter != nullptr && strstr(benchCase.name, filter) == nullptr)
+            continue;
+
+        // Same values on every run, so that runs can be compared
+        Random                   random(42 + c);
+        std::vector<uint64_t>    values(VALUE_COUNT);
+        std::vector<std::string> spellings(VALUE_COUNT);
+        for (size_t i = 0; i < VALUE_COUNT; ++i)
+        {
+            values[i]    = benchCase.distribution->generate(random);
+            spellings[i] = spell_out(values[i], benchCase.options);
+        }
+
+        for (size_t a = 0; a < sizeof(g_apiNames) / sizeof(g_apiNames[0]); ++a)
+        {
+            // Amounts are cardinals
+            const bool isAmount = (a == API_AMOUNT || a == API_AMOUNT_BATCH);
+            if (isAmount && (benchCase.options & (ORDINAL | CARDINAL_AS_ORDINAL)))
+                continue;
+
+            const Result result = measure(Api(a), values, spellings, benchCase.options, minSeconds);
+            if (json)
+            {
+                printf("%s\n    {\"case\": \"%s\", \"distribution\": \"%s\", \"options\": %u, \"api\": \"%s\", "
+                       "\"ns_per_call\": %.2f, \"bytes_per_second\": %.0f, \"allocations_per_call\": %.3f}",
+                       first ? "" : ",", benchCase.name, benchCase.distribution->name, benchCase.options, g_apiNames[a],
+                       result.nsPerCall, result.bytesPerSecond, result.allocationsPerCall);
+            }
+            else
+            {
+                printf("%-22s %-15s %12.1f %12.1f %14.3f\n", benchCase.name, g_apiNames[a],
+                       result.nsPerCall, result.bytesPerSecond / 1e6, result.allocationsPerCall);
+            }
+            first = false;
+        }
+    }
+
+    if (json)
+        printf("\n  ]\n}\n");
+    return EXIT_SUCCESS;
+}
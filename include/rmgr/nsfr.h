@@ -22,7 +22,45 @@
 #define RMGR_NSFR_H
 
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+
+#if defined(_MSVC_LANG)
+    #define RMGR_NSFR_CPLUSPLUS _MSVC_LANG
+#else
+    #define RMGR_NSFR_CPLUSPLUS __cplusplus
+#endif
+
+#if RMGR_NSFR_CPLUSPLUS >= 201703L && defined(__has_include)
+    #if __has_include(<string_view>)
+        #include <string_view>
+        #define RMGR_NSFR_HAS_STRING_VIEW 1
+    #endif
+    #if __has_include(<memory_resource>)
+        #include <memory_resource>
+        #define RMGR_NSFR_HAS_PMR 1
+    #endif
+#endif
+#ifndef RMGR_NSFR_HAS_STRING_VIEW
+    #define RMGR_NSFR_HAS_STRING_VIEW 0
+#endif
+#ifndef RMGR_NSFR_HAS_PMR
+    #define RMGR_NSFR_HAS_PMR 0
+#endif
+
+// Strict ISO modes leave std::numeric_limits unspecialized for __int128 in libstdc++
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__)
+    #define RMGR_NSFR_HAS_INT128 1
+#else
+    #define RMGR_NSFR_HAS_INT128 0
+#endif
 
 
 /**
@@ -84,11 +122,55 @@ const unsigned SWITZERLAND    = SEPTANTE | HUITANTE | NONANTE; ///< Use the Swis
 
 //=================================================================================================
 
+/**
+ * @brief The result of `to_words()`, modeled after `std::to_chars_result`
+ */
+struct to_words_result
+{
+    char*     ptr; ///< One past the last written character on success, `last` if the buffer is too small, `first` if the arguments are invalid
+    std::errc ec;  ///< `std::errc()` on success, `std::errc::value_too_large` if the buffer is too small, `std::errc::invalid_argument` if the arguments are invalid
+};
+
+
 /** @cond RmgrNsfrInternal */
 namespace internal
 {
+#if RMGR_NSFR_HAS_INT128
+    __extension__ typedef          __int128  int128_t;
+    __extension__ typedef unsigned __int128 uint128_t;
+    typedef uint128_t largest_uint_t; ///< The widest unsigned type numbers can be spelled out from
+#else
+    typedef uintmax_t largest_uint_t; ///< The widest unsigned type numbers can be spelled out from
+#endif
+
     std::string spell_out(intmax_t  value, unsigned options);
     std::string spell_out(uintmax_t value, unsigned options);
+
+    to_words_result to_words(char* first, char* last, intmax_t  value, unsigned options);
+    to_words_result to_words(char* first, char* last, uintmax_t value, unsigned options);
+
+    void append_to(std::string& str, intmax_t  value, unsigned options);
+    void append_to(std::string& str, uintmax_t value, unsigned options);
+
+    size_t spelled_length(intmax_t  value, unsigned options);
+    size_t spelled_length(uintmax_t value, unsigned options);
+
+    // Straight application of the rules, without any precomputed table (for testing purposes)
+    std::string spell_out_reference(intmax_t  value, unsigned options);
+    std::string spell_out_reference(uintmax_t value, unsigned options);
+
+#if RMGR_NSFR_HAS_INT128
+    std::string     spell_out(int128_t  value, unsigned options);
+    std::string     spell_out(uint128_t value, unsigned options);
+    to_words_result to_words(char* first, char* last, int128_t  value, unsigned options);
+    to_words_result to_words(char* first, char* last, uint128_t value, unsigned options);
+    void            append_to(std::string& str, int128_t  value, unsigned options);
+    void            append_to(std::string& str, uint128_t value, unsigned options);
+    size_t          spelled_length(int128_t  value, unsigned options);
+    size_t          spelled_length(uint128_t value, unsigned options);
+    std::string     spell_out_reference(int128_t  value, unsigned options);
+    std::string     spell_out_reference(uint128_t value, unsigned options);
+#endif
 }
 /** @endcond */
 
@@ -104,6 +186,1550 @@ inline std::string spell_out(signed   long      value, unsigned options=0) {retu
 inline std::string spell_out(unsigned long      value, unsigned options=0) {return internal::spell_out(uintmax_t(value), options);}
 inline std::string spell_out(signed   long long value, unsigned options=0) {return internal::spell_out( intmax_t(value), options);}
 inline std::string spell_out(unsigned long long value, unsigned options=0) {return internal::spell_out(uintmax_t(value), options);}
+#if RMGR_NSFR_HAS_INT128
+inline std::string spell_out(internal::int128_t  value, unsigned options=0) {return internal::spell_out(value, options);}
+inline std::string spell_out(internal::uint128_t value, unsigned options=0) {return internal::spell_out(value, options);}
+#endif
+
+
+/**
+ * @brief Spells out a number into a caller-provided buffer, without any memory allocation
+ *
+ * Just like `std::to_chars()`, the output is not null-terminated. Should the buffer be too small,
+ * `{last, std::errc::value_too_large}` is returned and the contents of the buffer are unspecified.
+ */
+inline to_words_result to_words(char* first, char* last, char               value, unsigned options=0) {return internal::to_words(first, last,  intmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, signed   char      value, unsigned options=0) {return internal::to_words(first, last,  intmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, unsigned char      value, unsigned options=0) {return internal::to_words(first, last, uintmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, signed   short     value, unsigned options=0) {return internal::to_words(first, last,  intmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, unsigned short     value, unsigned options=0) {return internal::to_words(first, last, uintmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, signed   int       value, unsigned options=0) {return internal::to_words(first, last,  intmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, unsigned int       value, unsigned options=0) {return internal::to_words(first, last, uintmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, signed   long      value, unsigned options=0) {return internal::to_words(first, last,  intmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, unsigned long      value, unsigned options=0) {return internal::to_words(first, last, uintmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, signed   long long value, unsigned options=0) {return internal::to_words(first, last,  intmax_t(value), options);}
+inline to_words_result to_words(char* first, char* last, unsigned long long value, unsigned options=0) {return internal::to_words(first, last, uintmax_t(value), options);}
+#if RMGR_NSFR_HAS_INT128
+inline to_words_result to_words(char* first, char* last, internal::int128_t  value, unsigned options=0) {return internal::to_words(first, last, value, options);}
+inline to_words_result to_words(char* first, char* last, internal::uint128_t value, unsigned options=0) {return internal::to_words(first, last, value, options);}
+#endif
+
+
+/**
+ * @brief Spells out a number at the end of an existing string
+ *
+ * The only memory allocation that may occur is the growth of @p str if its capacity is insufficient.
+ */
+inline void append_to(std::string& str, char               value, unsigned options=0) {internal::append_to(str,  intmax_t(value), options);}
+inline void append_to(std::string& str, signed   char      value, unsigned options=0) {internal::append_to(str,  intmax_t(value), options);}
+inline void append_to(std::string& str, unsigned char      value, unsigned options=0) {internal::append_to(str, uintmax_t(value), options);}
+inline void append_to(std::string& str, signed   short     value, unsigned options=0) {internal::append_to(str,  intmax_t(value), options);}
+inline void append_to(std::string& str, unsigned short     value, unsigned options=0) {internal::append_to(str, uintmax_t(value), options);}
+inline void append_to(std::string& str, signed   int       value, unsigned options=0) {internal::append_to(str,  intmax_t(value), options);}
+inline void append_to(std::string& str, unsigned int       value, unsigned options=0) {internal::append_to(str, uintmax_t(value), options);}
+inline void append_to(std::string& str, signed   long      value, unsigned options=0) {internal::append_to(str,  intmax_t(value), options);}
+inline void append_to(std::string& str, unsigned long      value, unsigned options=0) {internal::append_to(str, uintmax_t(value), options);}
+inline void append_to(std::string& str, signed   long long value, unsigned options=0) {internal::append_to(str,  intmax_t(value), options);}
+inline void append_to(std::string& str, unsigned long long value, unsigned options=0) {internal::append_to(str, uintmax_t(value), options);}
+#if RMGR_NSFR_HAS_INT128
+inline void append_to(std::string& str, internal::int128_t  value, unsigned options=0) {internal::append_to(str, value, options);}
+inline void append_to(std::string& str, internal::uint128_t value, unsigned options=0) {internal::append_to(str, value, options);}
+#endif
+
+
+/**
+ * @brief Computes the exact length (in bytes) of a number's spelling, without producing it
+ */
+inline size_t spelled_length(char               value, unsigned options=0) {return internal::spelled_length( intmax_t(value), options);}
+inline size_t spelled_length(signed   char      value, unsigned options=0) {return internal::spelled_length( intmax_t(value), options);}
+inline size_t spelled_length(unsigned char      value, unsigned options=0) {return internal::spelled_length(uintmax_t(value), options);}
+inline size_t spelled_length(signed   short     value, unsigned options=0) {return internal::spelled_length( intmax_t(value), options);}
+inline size_t spelled_length(unsigned short     value, unsigned options=0) {return internal::spelled_length(uintmax_t(value), options);}
+inline size_t spelled_length(signed   int       value, unsigned options=0) {return internal::spelled_length( intmax_t(value), options);}
+inline size_t spelled_length(unsigned int       value, unsigned options=0) {return internal::spelled_length(uintmax_t(value), options);}
+inline size_t spelled_length(signed   long      value, unsigned options=0) {return internal::spelled_length( intmax_t(value), options);}
+inline size_t spelled_length(unsigned long      value, unsigned options=0) {return internal::spelled_length(uintmax_t(value), options);}
+inline size_t spelled_length(signed   long long value, unsigned options=0) {return internal::spelled_length( intmax_t(value), options);}
+inline size_t spelled_length(unsigned long long value, unsigned options=0) {return internal::spelled_length(uintmax_t(value), options);}
+#if RMGR_NSFR_HAS_INT128
+inline size_t spelled_length(internal::int128_t  value, unsigned options=0) {return internal::spelled_length(value, options);}
+inline size_t spelled_length(internal::uint128_t value, unsigned options=0) {return internal::spelled_length(value, options);}
+#endif
+
+
+/**
+ * @brief Computes the spelled lengths of a whole array of numbers at once
+ *
+ * @param values  The numbers to measure
+ * @param count   The number of elements in @p values
+ * @param lengths Where to store the lengths, must have room for @p count elements
+ * @param options The formatting options, common to all numbers
+ *
+ * @return The sum of all lengths
+ */
+template<typename T>
+inline size_t spelled_lengths(const T* values, size_t count, size_t* lengths, unsigned options=0)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        lengths[i] = spelled_length(values[i], options);
+        total     += lengths[i];
+    }
+    return total;
+}
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    // Lengths (in bytes) of the words of the pool of nsfr_constexpr.h, checked by nsfr.cpp at compile time
+    constexpr unsigned char g_cardinalLengths[16]    = {2, 4, 5, 6, 4, 3, 4, 4, 4, 3, 4, 5, 6, 8, 6, 5};
+    constexpr unsigned char g_ordinalLengths[16]     = {7, 9, 10, 10, 10, 8, 9, 9, 9, 8, 8, 9, 10, 12, 10, 9};
+    constexpr unsigned char g_cardinalTensLengths[9] = {3, 5, 6, 8, 9, 8, 8, 8, 7};
+    constexpr unsigned char g_ordinalTensLengths[9]  = {8, 10, 10, 12, 13, 12, 12, 12, 11};
+    constexpr unsigned char g_numeralLengths[13]     = {4, 5, 7, 8, 7, 8, 8, 9, 11, 12, 11, 12, 10}; // From "cent" to "sextillion"
+
+    constexpr size_t max_size(size_t a, size_t b) {return (a < b) ? b : a;}
+
+    constexpr size_t below17_length(unsigned value, unsigned options)
+    {
+        return (options & ORDINAL)                 ? g_ordinalLengths[value-1]
+             : (value==1u && (options & FEMININE)) ? 3u // "une"
+             :                                       g_cardinalLengths[value-1];
+    }
+
+    constexpr size_t tens_length(unsigned tens, unsigned options)
+    {
+        return (tens==8u && (options & OCTANTE)) ? ((options & ORDINAL) ? 11u : 7u) // "octanti\xC3\xA8me" or "octante"
+             : (options & ORDINAL)                ? g_ordinalTensLengths[tens-1]
+             :                                      g_cardinalTensLengths[tens-1];
+    }
+
+    /**
+     * @brief Length of a number within [1;99], mirrors recursive_format() & format70_99()
+     */
+    constexpr size_t below100_length(unsigned value, unsigned options, bool plural)
+    {
+        return (value < 17u) ? below17_length(value, options)
+             : (   (value <= 69u)
+                || (value <= 79u && (options & SEPTANTE))
+                || (value <= 89u && (options & (HUITANTE | OCTANTE)))
+                || (options & NONANTE))
+                 ? ((value % 10u == 0u) ? tens_length(value / 10u, options)
+                                        : tens_length(value / 10u, options & ~ORDINAL) + ((value % 10u == 1u) ? 4u : 1u) + below17_length(value % 10u, options))
+             : (value <= 79u) ? 8u + ((value == 71u) ? 4u : 1u) + below100_length(value - 60u, options, false) // "soixante"
+             : (value == 80u) ? 12u + ((options & ORDINAL) ? 5u : plural ? 1u : 0u)                            // "quatre-vingt"
+             :                  12u + 1u + below100_length(value - 80u, options, false);
+    }
+
+    /**
+     * @brief Length of a number within [1;999], mirrors recursive_format()
+     */
+    constexpr size_t group_length(unsigned value, unsigned options, bool plural)
+    {
+        return (value < 100u) ? below100_length(value, options, plural)
+             : ((value >= 200u) ? g_cardinalLengths[value/100u - 1] + 1u : 0u) + 4u // "cent"
+               + ((value % 100u != 0u)     ? 1u + below100_length(value % 100u, options, plural)
+                  : (options & ORDINAL)    ? 5u
+                  : (plural && value>=200) ? 1u
+                  :                          0u);
+    }
+
+    constexpr size_t max_group_length(unsigned first, unsigned last, unsigned options, bool plural)
+    {
+        return (first == last) ? group_length(first, options, plural)
+             : max_size(max_group_length(first, (first + last) / 2u, options, plural),
+                        max_group_length((first + last) / 2u + 1u, last, options, plural));
+    }
+
+    /**
+     * @brief Maximum length of group #index (i.e. the multiplier, the numeral and the following space)
+     */
+    constexpr size_t max_numeral_part_length(unsigned index, unsigned maxGroup, unsigned options, bool plural)
+    {
+        return (index == 1u) ? ((maxGroup >= 2u) ? max_group_length(2u, maxGroup, options, false) + 1u : 0u) + 5u + 1u
+             : max_group_length(1u, maxGroup, options, plural) + 1u + g_numeralLengths[index] + ((maxGroup >= 2u) ? 1u : 0u) + 1u;
+    }
+
+    constexpr size_t max_tail_length(unsigned index, unsigned options, unsigned multiplierOptions, bool plural)
+    {
+        return (index == 0u) ? max_group_length(1u, 999u, options, plural)
+             : max_numeral_part_length(index, 999u, multiplierOptions, plural) + max_tail_length(index - 1u, options, multiplierOptions, plural);
+    }
+
+    constexpr unsigned group_count(largest_uint_t value)
+    {
+        return (value < 1000u) ? 1u : 1u + group_count(value / 1000u);
+    }
+
+    constexpr largest_uint_t power_of_1000(unsigned exponent)
+    {
+        return (exponent == 0u) ? 1u : 1000u * power_of_1000(exponent - 1u);
+    }
+
+    constexpr size_t max_magnitude_length(largest_uint_t maxValue, unsigned groupCount, unsigned options, bool plural)
+    {
+        return (groupCount == 1u) ? max_group_length(1u, unsigned(maxValue), options, plural)
+             : max_numeral_part_length(groupCount - 1u, unsigned(maxValue / power_of_1000(groupCount - 1u)), options & ~(FEMININE | ORDINAL), plural)
+               + max_tail_length(groupCount - 2u, options, options & ~(FEMININE | ORDINAL), plural);
+    }
+
+    constexpr size_t max_length(largest_uint_t maxValue, bool isSigned, unsigned options)
+    {
+        return ((isSigned && !(options & ORDINAL)) ? 6u : 0u) // "moins "
+             + max_size((options & ORDINAL) ? 10u : 5u,      // "z\xC3\xA9roi\xC3\xA8me" or "z\xC3\xA9ro"
+                        max_magnitude_length(maxValue, group_count(maxValue), options, !(options & (ORDINAL | CARDINAL_AS_ORDINAL))));
+    }
+
+    constexpr unsigned length_options(unsigned options)
+    {
+        // "huitante" overrides "octante"
+        return ((options & HUITANTE) ? (options & ~OCTANTE) : options) & ~CARDINAL_AS_ORDINAL;
+    }
+}
+/** @endcond */
+
+
+/**
+ * @brief Upper bound of `spelled_length()` for any value of type `T`, usable to size fixed buffers
+ *
+ * The bound is exact for 8, 16 and 64-bit types. For other types, it may exceed the actual maximum
+ * by a few bytes.
+ */
+template<typename T>
+constexpr size_t max_spelled_length(unsigned options=0)
+{
+    return (options & ORDINAL_SUFFIX) ? 2u
+         : internal::max_length(internal::largest_uint_t(std::numeric_limits<T>::max()) + (std::numeric_limits<T>::is_signed ? 1u : 0u),
+                                std::numeric_limits<T>::is_signed, internal::length_options(options));
+}
+
+
+//=================================================================================================
+// Profiles
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    struct Profile;
+
+    const Profile* resolve_profile(unsigned options);
+    unsigned       profile_options(const Profile& profile);
+
+    std::string     spell_out(const Profile& profile, intmax_t  value);
+    std::string     spell_out(const Profile& profile, uintmax_t value);
+    to_words_result to_words(const Profile& profile, char* first, char* last, intmax_t  value);
+    to_words_result to_words(const Profile& profile, char* first, char* last, uintmax_t value);
+    void            append_to(const Profile& profile, std::string& str, intmax_t  value);
+    void            append_to(const Profile& profile, std::string& str, uintmax_t value);
+    size_t          spelled_length(const Profile& profile, intmax_t  value);
+    size_t          spelled_length(const Profile& profile, uintmax_t value);
+
+    /**
+     * @brief The type all values of type `T` are converted to before being spelled out
+     */
+    template<typename T>
+    struct Widest
+    {
+        static_assert(std::numeric_limits<T>::is_integer, "Only integers can be spelled out");
+        typedef typename std::conditional<std::numeric_limits<T>::is_signed, intmax_t, uintmax_t>::type type;
+    };
+
+#if RMGR_NSFR_HAS_INT128
+    template<> struct Widest<int128_t>  {typedef int128_t  type;};
+    template<> struct Widest<uint128_t> {typedef uint128_t type;};
+
+    std::string     spell_out(const Profile& profile, int128_t  value);
+    std::string     spell_out(const Profile& profile, uint128_t value);
+    to_words_result to_words(const Profile& profile, char* first, char* last, int128_t  value);
+    to_words_result to_words(const Profile& profile, char* first, char* last, uint128_t value);
+    void            append_to(const Profile& profile, std::string& str, int128_t  value);
+    void            append_to(const Profile& profile, std::string& str, uint128_t value);
+    size_t          spelled_length(const Profile& profile, int128_t  value);
+    size_t          spelled_length(const Profile& profile, uint128_t value);
+#endif
+}
+/** @endcond */
+
+
+/**
+ * @brief A set of options resolved once, to spell out many numbers the same way
+ *
+ * The free functions taking `unsigned options` resolve them on every call, whereas a profile
+ * does so only once, at construction. This is a lightweight handle: the resolved profiles are
+ * shared and live until the end of the program, so it may be freely copied.
+ */
+class profile
+{
+public:
+    explicit profile(unsigned options=0): m_profile(internal::resolve_profile(options)) {}
+
+    unsigned options() const {return internal::profile_options(*m_profile);}
+
+    template<typename T> std::string     spell_out(T value) const                        {return internal::spell_out(*m_profile, typename internal::Widest<T>::type(value));}
+    template<typename T> to_words_result to_words(char* first, char* last, T value) const {return internal::to_words(*m_profile, first, last, typename internal::Widest<T>::type(value));}
+    template<typename T> void            append_to(std::string& str, T value) const      {internal::append_to(*m_profile, str, typename internal::Widest<T>::type(value));}
+    template<typename T> size_t          spelled_length(T value) const                   {return internal::spelled_length(*m_profile, typename internal::Widest<T>::type(value));}
+
+private:
+    const internal::Profile* m_profile;
+};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    template<unsigned Options>
+    const profile& profile_for()
+    {
+        static const profile s_profile(Options);
+        return s_profile;
+    }
+}
+/** @endcond */
+
+
+/**
+ * @brief Variants of the free functions whose options are known at compile time
+ *
+ * For example, `spell_out<ORDINAL | FEMININE>(80)`. The options are only resolved on first use.
+ */
+template<unsigned Options, typename T> std::string     spell_out(T value)                        {return internal::profile_for<Options>().spell_out(value);}
+template<unsigned Options, typename T> to_words_result to_words(char* first, char* last, T value) {return internal::profile_for<Options>().to_words(first, last, value);}
+template<unsigned Options, typename T> void            append_to(std::string& str, T value)      {internal::profile_for<Options>().append_to(str, value);}
+template<unsigned Options, typename T> size_t          spelled_length(T value)                   {return internal::profile_for<Options>().spelled_length(value);}
+
+
+//=================================================================================================
+// Batches
+
+/**
+ * @brief The spellings of many numbers, stored back-to-back in a single buffer
+ *
+ * This is laid out just like an Arrow string column: the spelling of element `i` spans
+ * `[offsets()[i]; offsets()[i+1])` within `data()`. Both buffers grow geometrically, so filling a
+ * column of `N` elements only takes `O(log N)` memory allocations.
+ */
+template<typename Allocator = std::allocator<char>>
+class basic_spelled_column
+{
+public:
+    typedef Allocator allocator_type;
+
+    explicit basic_spelled_column(const Allocator& allocator = Allocator()):
+        m_bytes(allocator),
+        m_offsets(1, 0, OffsetAllocator(allocator))
+    {
+    }
+
+    size_t         size()      const {return m_offsets.size() - 1;}                ///< The number of elements
+    bool           empty()     const {return m_offsets.size() == 1;}
+    size_t         byte_size() const {return m_offsets.back();}                    ///< The total length of all spellings
+    const char*    data()      const {return m_bytes.data();}                      ///< The spellings, back-to-back
+    const size_t*  offsets()   const {return m_offsets.data();}                    ///< `size()+1` offsets within `data()`
+    const char*    begin(size_t i)  const {return m_bytes.data() + m_offsets[i];}   ///< The start of element `i`
+    size_t         length(size_t i) const {return m_offsets[i+1] - m_offsets[i];}  ///< The length of element `i`
+    std::string    str(size_t i)    const {return std::string(begin(i), length(i));}
+#if RMGR_NSFR_HAS_STRING_VIEW
+    std::string_view operator[](size_t i) const {return std::string_view(begin(i), length(i));}
+#endif
+
+    allocator_type get_allocator() const {return m_bytes.get_allocator();}
+
+    /**
+     * @brief Preallocates room for @p count more elements, totalling @p byteCount more bytes
+     */
+    void reserve(size_t count, size_t byteCount)
+    {
+        m_offsets.reserve(m_offsets.size() + count);
+        if (m_bytes.size() - byte_size() < byteCount)
+            m_bytes.resize(byte_size() + byteCount);
+    }
+
+    void clear()
+    {
+        m_offsets.resize(1);
+    }
+
+    template<typename T>
+    void push_back(T value, unsigned options=0)
+    {
+        push_back(value, profile(options));
+    }
+
+    template<typename T>
+    void push_back(T value, const profile& prof)
+    {
+        push_back_with(max_spelled_length<T>(prof.options()), [&](char* first, char* last) {return prof.to_words(first, last, value);});
+    }
+
+    /**
+     * @brief Appends an element written by @p write, which behaves like `to_words()`
+     *
+     * @param maxLength The maximum length @p write may need
+     * @param write     Called as `to_words_result write(char* first, char* last)`, an error leaves an empty element
+     */
+    template<typename Write>
+    void push_back_with(size_t maxLength, Write write)
+    {
+        const size_t used = byte_size();
+        if (m_bytes.size() - used < maxLength)
+        {
+            // The bytes vector's size acts as its capacity, as its tail is written through to_words()
+            const size_t newSize = (2 * m_bytes.size() > used + maxLength) ? 2 * m_bytes.size() : used + maxLength;
+            m_bytes.resize(newSize);
+        }
+        char* first = &m_bytes[0] + used;
+        const to_words_result result = write(first, first + maxLength);
+        m_offsets.push_back((result.ec == std::errc()) ? used + size_t(result.ptr - first) : used);
+    }
+
+    /**
+     * @brief Appends @p count elements totalling @p byteCount bytes, that the caller then writes
+     *
+     * The column is only valid again once all the bytes and ends are written.
+     *
+     * @param bytes Receives where the bytes of the new elements go
+     * @param ends  Receives where the end offsets of the new elements go, as offsets within `data()`
+     *
+     * @return The offset of the first new byte within `data()`
+     */
+    size_t append_uninitialized(size_t count, size_t byteCount, char*& bytes, size_t*& ends)
+    {
+        const size_t used = byte_size();
+        if (m_bytes.size() - used < byteCount)
+            m_bytes.resize(used + byteCount);
+        m_offsets.resize(m_offsets.size() + count);
+        bytes = m_bytes.data() + used;
+        ends  = m_offsets.data() + m_offsets.size() - count;
+        return used;
+    }
+
+private:
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<size_t> OffsetAllocator;
+
+    std::vector<char,   Allocator>       m_bytes;   ///< Only the first `byte_size()` bytes are meaningful
+    std::vector<size_t, OffsetAllocator> m_offsets; ///< Always starts with a 0
+};
+
+
+typedef basic_spelled_column<> spelled_column;
+
+#if RMGR_NSFR_HAS_PMR
+namespace pmr
+{
+    typedef basic_spelled_column<std::pmr::polymorphic_allocator<char>> spelled_column;
+}
+#endif
+
+
+/**
+ * @brief Appends the spellings of many numbers to a column, sharing the same options
+ */
+template<typename T, typename Allocator>
+void spell_out_batch(basic_spelled_column<Allocator>& column, const T* values, size_t count, unsigned options=0)
+{
+    const profile prof(options);
+    column.reserve(count, 0);
+    for (size_t i = 0; i < count; ++i)
+        column.push_back(values[i], prof);
+}
+
+
+/**
+ * @brief Appends the spellings of many numbers to a column, each one with its own options
+ *
+ * @param options The options of each number, must have @p count elements
+ */
+template<typename T, typename Allocator>
+void spell_out_batch(basic_spelled_column<Allocator>& column, const T* values, size_t count, const unsigned* options)
+{
+    column.reserve(count, 0);
+    for (size_t i = 0; i < count; ++i)
+        column.push_back(values[i], options[i]);
+}
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    /**
+     * @brief A batch to spell out on several threads, with the types erased so that the scheduling
+     *        can live in the library
+     */
+    struct ParallelBatch
+    {
+        const void* source;    ///< The values and how to spell them out
+        size_t      count;     ///< The number of values
+        size_t      maxLength; ///< The maximum length of a spelling
+        void*       column;    ///< Where the spellings go
+
+        /** @brief Spells value @p i out, like `to_words()` */
+        to_words_result (*write)(const void* source, size_t i, char* first, char* last);
+
+        /** @brief Makes room for the spellings in the column, see `basic_spelled_column::append_uninitialized()` */
+        size_t (*append)(void* column, size_t count, size_t byteCount, char*& bytes, size_t*& ends);
+    };
+
+    void spell_out_parallel(const ParallelBatch& batch, unsigned threadCount);
+}
+/** @endcond */
+
+
+/**
+ * @brief Appends the spellings of many numbers to a column, spelling them out on several threads
+ *
+ * The values are split into chunks, that each thread spells out into buffers of its own, taking
+ * chunks from the others once done with its share. These buffers are then stitched into the
+ * column in input order, so that the result is that of `spell_out_batch()`.
+ *
+ * @param threadCount The number of threads, the calling one included, 0 for as many as the
+ *                    hardware runs concurrently
+ */
+template<typename T, typename Allocator>
+void spell_out_parallel(basic_spelled_column<Allocator>& column, const T* values, size_t count, unsigned options = 0, unsigned threadCount = 0)
+{
+    struct Source
+    {
+        const T*       values;
+        const profile* prof;
+    };
+
+    const profile prof(options);
+    const Source  source = {values, &prof};
+
+    internal::ParallelBatch batch;
+    batch.source    = &source;
+    batch.count     = count;
+    batch.maxLength = max_spelled_length<T>(prof.options());
+    batch.write     = [](const void* source_, size_t i, char* first, char* last) -> to_words_result
+    {
+        const Source& src = *static_cast<const Source*>(source_);
+        return src.prof->to_words(first, last, src.values[i]);
+    };
+    batch.column    = &column;
+    batch.append    = [](void* column_, size_t count_, size_t byteCount, char*& bytes, size_t*& ends) -> size_t
+    {
+        return static_cast<basic_spelled_column<Allocator>*>(column_)->append_uninitialized(count_, byteCount, bytes, ends);
+    };
+    internal::spell_out_parallel(batch, threadCount);
+}
+
+
+//=================================================================================================
+// Parsing
+
+/**
+ * @brief The result of `parse()`, modeled after `std::from_chars_result`
+ */
+struct parse_result
+{
+    const char* ptr;      ///< One past the last word of the number, `first` if there is none
+    std::errc   ec;       ///< `std::errc()` on success, `std::errc::invalid_argument` if there is no number, `std::errc::result_out_of_range` if it is too large
+    uintmax_t   value;    ///< The absolute value of the number
+    bool        negative; ///< Whether the number is preceded by "moins"
+    unsigned    options;  ///< How the number is spelled: type, gender and variants (e.g. `ORDINAL | FEMININE | SEPTANTE`)
+};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    parse_result parse(const char* first, const char* last);
+}
+/** @endcond */
+
+
+/**
+ * @brief Reads a number spelled out in French, the inverse of `spell_out()`
+ *
+ * Words must be separated by a single space or hyphen, which means the 1990 spelling ("deux-cent-
+ * vingt-et-un") is supported too. All variants are recognized, they are reported in the options of
+ * the result. Just like `std::from_chars()`, parsing stops at the first word that cannot be part of
+ * the number, so trailing text is allowed. No memory is allocated.
+ */
+inline parse_result parse(const char* first, const char* last) {return internal::parse(first, last);}
+#if RMGR_NSFR_HAS_STRING_VIEW
+inline parse_result parse(std::string_view str)               {return internal::parse(str.data(), str.data() + str.size());}
+#endif
+
+
+//=================================================================================================
+// Decimal strings
+
+/**
+ * @brief Receives a spelling piece by piece, see `spell_out_decimal()`
+ */
+typedef void (*write_function)(void* context, const char* str, size_t length);
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    std::errc spell_out_decimal(const char* first, const char* last, unsigned options, write_function write, void* context);
+    std::errc append_decimal_to(std::string& str, const char* first, const char* last, unsigned options);
+}
+/** @endcond */
+
+
+/**
+ * @brief Spells out a number of any size, given as a string of decimal digits
+ *
+ * The digits may be preceded by a minus sign and leading zeros. They are read three at a time from
+ * the most significant ones and the names of the powers of 1000 are generated along the way: million,
+ * milliard, billion, billiard, ..., vigintillion, ..., centillion, ... (the Conway-Wechsler system extends
+ * the long scale beyond the usual names). This takes linear time and no memory besides the output,
+ * which is handed over to @p write in chunks.
+ *
+ * @return `std::errc::invalid_argument` if the string is not a decimal number, or is negative while
+ *         an ordinal is requested, in which case nothing is output
+ */
+inline std::errc spell_out_decimal(const char* first, const char* last, unsigned options, write_function write, void* context)
+{
+    return internal::spell_out_decimal(first, last, options, write, context);
+}
+
+
+/**
+ * @brief Appends the spelling of a string of decimal digits, see `spell_out_decimal()`
+ *
+ * @return `std::errc::invalid_argument` if the string is not a decimal number, in which case @p str is left untouched
+ */
+inline std::errc append_decimal_to(std::string& str, const char* first, const char* last, unsigned options = 0)
+{
+    return internal::append_decimal_to(str, first, last, options);
+}
+
+
+/**
+ * @brief Spells out a string of decimal digits, see `spell_out_decimal()`
+ *
+ * @return The spelling, empty if the string is not a decimal number
+ */
+inline std::string spell_out_decimal(const char* first, const char* last, unsigned options = 0)
+{
+    std::string str;
+    internal::append_decimal_to(str, first, last, options);
+    return str;
+}
+
+
+#if RMGR_NSFR_HAS_STRING_VIEW
+inline std::errc spell_out_decimal(std::string_view digits, unsigned options, write_function write, void* context)
+{
+    return internal::spell_out_decimal(digits.data(), digits.data() + digits.size(), options, write, context);
+}
+
+inline std::errc append_decimal_to(std::string& str, std::string_view digits, unsigned options = 0)
+{
+    return internal::append_decimal_to(str, digits.data(), digits.data() + digits.size(), options);
+}
+
+inline std::string spell_out_decimal(std::string_view digits, unsigned options = 0)
+{
+    return spell_out_decimal(digits.data(), digits.data() + digits.size(), options);
+}
+#endif
+
+
+//=================================================================================================
+// Fixed-point and floating-point numbers
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    to_words_result to_words_fixed(char* first, char* last, intmax_t mantissa, unsigned scale, unsigned options, const char* decimalWord);
+    std::string     spell_out_fixed(intmax_t mantissa, unsigned scale, unsigned options, const char* decimalWord);
+    to_words_result to_words(char* first, char* last, double value, unsigned options, const char* decimalWord);
+    std::string     spell_out(double value, unsigned options, const char* decimalWord);
+}
+/** @endcond */
+
+
+/**
+ * @brief Spells out the fixed-point number `mantissa * 10^-scale`, e.g. 123456 with a scale of 2 is
+ *        "mille deux cent trente-quatre virgule cinquante-six"
+ *
+ * The fractional part is spelled as a number of 10^-scale units, its leading zeros being spelled one
+ * by one ("un virgule zero cinq" for 105 with a scale of 2). It is omitted when it is zero. Both
+ * parts are cardinals, so ordinal options are an error (`std::errc::invalid_argument`).
+ *
+ * @param decimalWord The word between both parts
+ */
+inline to_words_result to_words_fixed(char* first, char* last, intmax_t mantissa, unsigned scale, unsigned options = 0, const char* decimalWord = "virgule")
+{
+    return internal::to_words_fixed(first, last, mantissa, scale, options, decimalWord);
+}
+
+
+/**
+ * @brief Spells out a fixed-point number, see `to_words_fixed()`
+ *
+ * @return The spelling, empty on error
+ */
+inline std::string spell_out_fixed(intmax_t mantissa, unsigned scale, unsigned options = 0, const char* decimalWord = "virgule")
+{
+    return internal::spell_out_fixed(mantissa, scale, options, decimalWord);
+}
+
+
+/**
+ * @brief Spells out the shortest decimal representation of @p value that reads back to it, e.g.
+ *        0.005 is "zero virgule zero zero cinq", see `to_words_fixed()`
+ *
+ * Infinities and NaNs are an error (`std::errc::invalid_argument`).
+ */
+inline to_words_result to_words(char* first, char* last, double value, unsigned options = 0, const char* decimalWord = "virgule")
+{
+    return internal::to_words(first, last, value, options, decimalWord);
+}
+
+
+/**
+ * @brief Spells out a floating-point number, see `to_words(char*, char*, double, unsigned, const char*)`
+ *
+ * @return The spelling, empty on error
+ */
+inline std::string spell_out(double value, unsigned options = 0, const char* decimalWord = "virgule")
+{
+    return internal::spell_out(value, options, decimalWord);
+}
+
+
+//=================================================================================================
+// Amounts
+
+/**
+ * @brief The words of a currency, for spelling out amounts
+ */
+struct currency
+{
+    const char* unit;          ///< e.g. "euro"
+    const char* units;         ///< e.g. "euros"
+    unsigned    unitGender;    ///< `MASCULINE` or `FEMININE`
+    const char* subunit;       ///< e.g. "centime"
+    const char* subunits;      ///< e.g. "centimes"
+    unsigned    subunitGender; ///< `MASCULINE` or `FEMININE`
+    unsigned    subunitDigits; ///< The number of digits of subunits, within [0;9] (e.g. 2 as 1 euro is 100 centimes)
+};
+
+const currency EURO           = {"euro",  "euros",  MASCULINE, "centime", "centimes", MASCULINE, 2};
+const currency SWISS_FRANC    = {"franc", "francs", MASCULINE, "centime", "centimes", MASCULINE, 2};
+const currency POUND_STERLING = {"livre", "livres", FEMININE,  "penny",   "pence",    MASCULINE, 2};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    to_words_result to_words_amount(char* first, char* last, intmax_t amount, const currency& cur, unsigned options);
+    std::string     spell_out_amount(intmax_t amount, const currency& cur, unsigned options);
+    size_t          max_spelled_amount_length(const currency& cur, unsigned options);
+}
+/** @endcond */
+
+
+/**
+ * @brief Spells out an amount of money, e.g. 123050 is "mille deux cent trente euros et cinquante centimes"
+ *
+ * The nouns agree with the numbers: "zero euro", "un euro", "deux euros", "un million d'euros".
+ * Numbers take the gender of their noun ("une livre"), so only the variants of @p options (e.g.
+ * `BELGIUM`) are relevant and ordinal types are an error (`std::errc::invalid_argument`), as is a
+ * currency with more than 9 subunit digits. A part which is zero is omitted, unless the whole
+ * amount is zero.
+ *
+ * @param amount The amount in subunits (e.g. cents)
+ */
+inline to_words_result to_words_amount(char* first, char* last, intmax_t amount, const currency& cur = EURO, unsigned options = 0)
+{
+    return internal::to_words_amount(first, last, amount, cur, options);
+}
+
+
+/**
+ * @brief Spells out an amount of money, see `to_words_amount()`
+ *
+ * @return The spelling, empty on error
+ */
+inline std::string spell_out_amount(intmax_t amount, const currency& cur = EURO, unsigned options = 0)
+{
+    return internal::spell_out_amount(amount, cur, options);
+}
+
+
+/**
+ * @brief The maximum length of the spelling of an amount of money
+ */
+inline size_t max_spelled_amount_length(const currency& cur = EURO, unsigned options = 0)
+{
+    return internal::max_spelled_amount_length(cur, options);
+}
+
+
+/**
+ * @brief Appends the spellings of many amounts of money to a column, see `to_words_amount()`
+ */
+template<typename Allocator>
+void spell_out_amount_batch(basic_spelled_column<Allocator>& column, const intmax_t* amounts, size_t count, const currency& cur = EURO, unsigned options = 0)
+{
+    const size_t maxLength = max_spelled_amount_length(cur, options);
+    column.reserve(count, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const intmax_t amount = amounts[i];
+        column.push_back_with(maxLength, [&](char* first, char* last) {return to_words_amount(first, last, amount, cur, options);});
+    }
+}
+
+
+//=================================================================================================
+// Counters
+
+/**
+ * @brief Spells out consecutive numbers (pages, lines, tickets, ...), updating the spelling in place
+ *
+ * Incrementing only rewrites the spelling of the base-1000 groups that change, usually just the last
+ * one, plural and "et" included: "quatre-vingts" becomes "quatre-vingt-un". The cost is therefore
+ * proportional to the length of these groups rather than to the length of the whole spelling.
+ */
+class counter
+{
+public:
+    explicit counter(uintmax_t value = 0, unsigned options = 0);
+
+    uintmax_t          value()   const {return m_value;}
+    unsigned           options() const;
+    const std::string& str()     const {return m_spelling;}  ///< The spelling of `value()`
+#if RMGR_NSFR_HAS_STRING_VIEW
+    std::string_view   view()    const {return m_spelling;}  ///< The spelling of `value()`
+#endif
+
+    /** @brief Moves to the next number, wrapping around to zero after `UINTMAX_MAX` */
+    counter& operator++();
+
+    /** @brief Moves to an arbitrary number, spelling it out from scratch */
+    void reset(uintmax_t value);
+
+private:
+    static const unsigned GROUP_CAPACITY = (std::numeric_limits<uintmax_t>::digits10 + 3) / 3;
+
+    void format_from(unsigned top);
+
+    const internal::Profile* m_profile;
+    uintmax_t                m_value;
+    std::string              m_spelling;
+    unsigned                 m_groups[GROUP_CAPACITY]; ///< The base-1000 groups of `m_value`, the least significant one first
+    size_t                   m_starts[GROUP_CAPACITY]; ///< Where the spelling of each non-zero group starts within `m_spelling`
+};
+
+
+//=================================================================================================
+// Caches
+
+/**
+ * @brief A spelling held by a `spelling_cache`, which remains valid once evicted from it
+ */
+typedef std::shared_ptr<const std::string> cached_spelling;
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    struct CacheShard;
+}
+/** @endcond */
+
+
+/**
+ * @brief A bounded, thread-safe cache of spellings, for when a few values make up most of the calls
+ *
+ * Keys are spread over shards, each one with its own lock, so that threads seldom contend. Each
+ * shard evicts with the CLOCK policy, an approximation of LRU that only costs a bit per entry. Keys
+ * are made of the value and of its options, normalized the way `spell_out()` interprets them (e.g.
+ * `HUITANTE | OCTANTE` is the same as `HUITANTE`).
+ *
+ * Spellings are handed out as shared pointers rather than views, so that they outlive their
+ * eviction. A hit therefore takes the lock of its shard, under which it sets its reference bit, and
+ * increments the reference count of the spelling atomically.
+ */
+class spelling_cache
+{
+public:
+    /**
+     * @param capacity   The maximum number of spellings, split evenly among shards
+     * @param shardCount The number of shards, which bounds the number of threads that don't contend
+     */
+    explicit spelling_cache(size_t capacity = 4096, unsigned shardCount = 16);
+    ~spelling_cache();
+
+    spelling_cache(const spelling_cache&)            = delete;
+    spelling_cache& operator=(const spelling_cache&) = delete;
+
+    /** @brief Returns the spelling of @p value, spelling it out on a miss */
+    template<typename T>
+    cached_spelling spell_out(T value, unsigned options = 0)
+    {
+        static_assert(sizeof(T) <= sizeof(uintmax_t), "Only native integers can be cached");
+        return find(typename internal::Widest<T>::type(value), options);
+    }
+
+    uint64_t hits()     const; ///< The number of calls that found their spelling in the cache
+    uint64_t misses()   const; ///< The number of calls that had to spell out their value
+    size_t   size()     const; ///< The number of spellings currently held
+    size_t   capacity() const;
+
+    /** @brief Evicts all spellings, counters are kept */
+    void clear();
+
+private:
+    cached_spelling find(intmax_t value, unsigned options);
+    cached_spelling find(uintmax_t value, unsigned options);
+    cached_spelling find(bool negative, uintmax_t magnitude, unsigned options);
+
+    std::unique_ptr<internal::CacheShard[]> m_shards;
+    unsigned                                m_shardCount;
+};
+
+
+//=================================================================================================
+// Dictionaries
+
+/**
+ * @brief Writes the spellings of [0; @p valueCount) for several profiles into a dictionary file
+ *
+ * The file holds, for each profile, an index of offsets followed by the spellings back-to-back, so
+ * that `dictionary` can map it in memory and use it as is. Spellings come from the library itself.
+ *
+ * @param options      The options of each profile, must have @p profileCount elements
+ *
+ * @return `std::errc()` on success, an error from the system otherwise, or
+ *         `std::errc::value_too_large` if the spellings of a profile exceed 4 GiB, which is
+ *         known beforehand when @p valueCount reaches 2^31
+ */
+std::errc write_dictionary(const char* path, uintmax_t valueCount, const unsigned* options, size_t profileCount);
+
+
+/**
+ * @brief A dictionary file written by `write_dictionary()`, mapped in memory
+ *
+ * Opening only checks the header, the spellings are then read straight from the mapped pages, which
+ * are shared by all processes using the same file. Lookups take constant time and return pointers
+ * into the mapping, which remain valid until the dictionary is closed.
+ */
+class dictionary
+{
+public:
+    dictionary();
+    ~dictionary();
+
+    dictionary(dictionary&& other);
+    dictionary& operator=(dictionary&& other);
+
+    dictionary(const dictionary&)            = delete;
+    dictionary& operator=(const dictionary&) = delete;
+
+    /**
+     * @return `std::errc()` on success, an error from the system, `std::errc::invalid_argument` if
+     *         this is not a dictionary, or `std::errc::not_supported` for another version or byte order
+     */
+    std::errc open(const char* path);
+    void      close();
+    bool      is_open() const {return m_data != nullptr;}
+
+    uintmax_t size() const;                      ///< Spellings of the values within [0; size()) are available
+    bool      contains(unsigned options) const;  ///< Whether the dictionary has a profile for these options
+
+    /**
+     * @brief Finds the spelling of @p value with the given options
+     *
+     * @return Whether it was found, false if the value is too large or there is no such profile
+     */
+    bool find(uintmax_t value, unsigned options, const char*& spelling, size_t& length) const;
+
+#if RMGR_NSFR_HAS_STRING_VIEW
+    /** @brief Returns the spelling of @p value, empty if not found */
+    std::string_view lookup(uintmax_t value, unsigned options = 0) const
+    {
+        const char* spelling = nullptr;
+        size_t      length   = 0;
+        return find(value, options, spelling, length) ? std::string_view(spelling, length) : std::string_view();
+    }
+#endif
+
+private:
+    const unsigned char* m_data;
+    size_t               m_size;
+    void*                m_mapping; ///< The file mapping handle on Windows
+};
+
+
+//=================================================================================================
+// Tokens
+
+/**
+ * @brief All the words, joiners and endings spelled numbers are made of, as `X(name, text)`
+ *
+ * This list defines `token`, and the tables of words used for spelling out are generated from it.
+ */
+#define RMGR_NSFR_TOKEN_LIST(X) \
+    X(UN,                    "un")                       X(DEUX,                  "deux")                     \
+    X(TROIS,                 "trois")                    X(QUATRE,                "quatre")                   \
+    X(CINQ,                  "cinq")                     X(SIX,                   "six")                      \
+    X(SEPT,                  "sept")                     X(HUIT,                  "huit")                     \
+    X(NEUF,                  "neuf")                     X(DIX,                   "dix")                      \
+    X(ONZE,                  "onze")                     X(DOUZE,                 "douze")                    \
+    X(TREIZE,                "treize")                   X(QUATORZE,              "quatorze")                 \
+    X(QUINZE,                "quinze")                   X(SEIZE,                 "seize")                    \
+    X(UNIEME,                "uni\xC3\xA8me")            X(DEUXIEME,              "deuxi\xC3\xA8me")          \
+    X(TROISIEME,             "troisi\xC3\xA8me")         X(QUATRIEME,             "quatri\xC3\xA8me")         \
+    X(CINQUIEME,             "cinqui\xC3\xA8me")         X(SIXIEME,               "sixi\xC3\xA8me")           \
+    X(SEPTIEME,              "septi\xC3\xA8me")          X(HUITIEME,              "huiti\xC3\xA8me")          \
+    X(NEUVIEME,              "neuvi\xC3\xA8me")          X(DIXIEME,               "dixi\xC3\xA8me")           \
+    X(ONZIEME,               "onzi\xC3\xA8me")           X(DOUZIEME,              "douzi\xC3\xA8me")          \
+    X(TREIZIEME,             "treizi\xC3\xA8me")         X(QUATORZIEME,           "quatorzi\xC3\xA8me")       \
+    X(QUINZIEME,             "quinzi\xC3\xA8me")         X(SEIZIEME,              "seizi\xC3\xA8me")          \
+    X(VINGT,                 "vingt")                    X(TRENTE,                "trente")                   \
+    X(QUARANTE,              "quarante")                 X(CINQUANTE,             "cinquante")                \
+    X(SOIXANTE,              "soixante")                 X(SEPTANTE,              "septante")                 \
+    X(HUITANTE,              "huitante")                 X(OCTANTE,               "octante")                  \
+    X(NONANTE,               "nonante")                                                                       \
+    X(VINGTIEME,             "vingti\xC3\xA8me")         X(TRENTIEME,             "trenti\xC3\xA8me")         \
+    X(QUARANTIEME,           "quaranti\xC3\xA8me")       X(CINQUANTIEME,          "cinquanti\xC3\xA8me")      \
+    X(SOIXANTIEME,           "soixanti\xC3\xA8me")       X(SEPTANTIEME,           "septanti\xC3\xA8me")       \
+    X(HUITANTIEME,           "huitanti\xC3\xA8me")       X(OCTANTIEME,            "octanti\xC3\xA8me")        \
+    X(NONANTIEME,            "nonanti\xC3\xA8me")                                                             \
+    X(NUMERAL_CENT,          "cent")                     X(NUMERAL_MILLE,         "mille")                    \
+    X(NUMERAL_MILLION,       "million")                  X(NUMERAL_MILLIARD,      "milliard")                 \
+    X(NUMERAL_BILLION,       "billion")                  X(NUMERAL_BILLIARD,      "billiard")                 \
+    X(NUMERAL_TRILLION,      "trillion")                 X(NUMERAL_TRILLIARD,     "trilliard")                \
+    X(NUMERAL_QUADRILLION,   "quadrillion")              X(NUMERAL_QUADRILLIARD,  "quadrilliard")             \
+    X(NUMERAL_QUINTILLION,   "quintillion")              X(NUMERAL_QUINTILLIARD,  "quintilliard")             \
+    X(NUMERAL_SEXTILLION,    "sextillion")               X(NUMERAL_MILLIEME,      "milli\xC3\xA8me")          \
+    X(ZERO,                  "z\xC3\xA9ro")              X(ZEROIEME,              "z\xC3\xA9roi\xC3\xA8me")   \
+    X(UNE,                   "une")                                                                           \
+    X(PREMIER,               "premier")                  X(PREMIERE,              "premi\xC3\xA8re")          \
+    X(SECOND,                "second")                   X(SECONDE,               "seconde")                  \
+    X(MOINS,                 "moins")                                                                         \
+    X(PLURAL_S,              "s")                        X(ORDINAL_IEME,          "i\xC3\xA8me")              \
+    X(SUFFIX_ER,             "er")                       X(SUFFIX_RE,             "re")                       \
+    X(SUFFIX_D,              "d")                        X(SUFFIX_DE,             "de")                       \
+    X(SUFFIX_E,              "e")                                                                             \
+    X(JOIN_HYPHEN,           "-")                        X(JOIN_ET,               " et ")                     \
+    X(JOIN_SPACE,            " ")
+
+
+/**
+ * @brief A word, joiner or ending of a spelled number, as emitted by `spell_tokens()`
+ *
+ * Concatenating the text of the tokens gives back the spelling, which `render()` does. Numerals
+ * (cent, mille, million, ...) are prefixed so that they stand out from the other words, and an
+ * ordinal noun is its cardinal followed by `ORDINAL_IEME` ("millionieme" is `NUMERAL_MILLION`,
+ * `ORDINAL_IEME`), as are the plural ones with `PLURAL_S`.
+ */
+enum class token : uint8_t
+{
+#define RMGR_NSFR_TOKEN_ENUMERATOR(name, text) name,
+    RMGR_NSFR_TOKEN_LIST(RMGR_NSFR_TOKEN_ENUMERATOR)
+#undef RMGR_NSFR_TOKEN_ENUMERATOR
+};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    const size_t MAX_TOKEN_COUNT = 256; ///< No number takes more tokens, even a 128-bit one
+
+    size_t spell_tokens(intmax_t  value, unsigned options, token* tokens);
+    size_t spell_tokens(uintmax_t value, unsigned options, token* tokens);
+#if RMGR_NSFR_HAS_INT128
+    size_t spell_tokens(int128_t  value, unsigned options, token* tokens);
+    size_t spell_tokens(uint128_t value, unsigned options, token* tokens);
+#endif
+
+    void append_rendered(std::string& str, const token* first, const token* last);
+}
+/** @endcond */
+
+
+/**
+ * @brief Spells out a number as tokens rather than text
+ *
+ * The tokens follow the very same rules as `spell_out()`, so that rendering them yields the same
+ * string, but word boundaries, joiners and plural marks are explicit. For instance, 80 gives
+ * `QUATRE`, `JOIN_HYPHEN`, `VINGT`, `PLURAL_S`.
+ *
+ * @param out Where to write the tokens, an output iterator accepting `token`
+ *
+ * @return The iterator past the last token written
+ */
+template<typename T, typename OutputIt>
+OutputIt spell_tokens(T value, unsigned options, OutputIt out)
+{
+    token tokens[internal::MAX_TOKEN_COUNT];
+    const size_t count = internal::spell_tokens(typename internal::Widest<T>::type(value), options, tokens);
+    for (size_t i = 0; i < count; ++i)
+        *out++ = tokens[i];
+    return out;
+}
+
+
+/**
+ * @brief Turns tokens back into text
+ */
+inline std::string render(const token* first, const token* last)
+{
+    std::string str;
+    internal::append_rendered(str, first, last);
+    return str;
+}
+
+
+/**
+ * @brief Turns tokens back into text, @p tokens being a contiguous container such as `std::vector<token>`
+ */
+template<typename Container>
+std::string render(const Container& tokens)
+{
+    const token* const first = tokens.data();
+    return render(first, first + tokens.size());
+}
+
+
+//=================================================================================================
+// Segments
+
+/**
+ * @brief A piece of a spelling, laid out like POSIX `struct iovec` so that it can be given to `writev()`
+ */
+struct spelled_segment
+{
+    const char* data;
+    size_t      length;
+};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    size_t to_segments(spelled_segment* segments, size_t capacity, intmax_t  value, unsigned options);
+    size_t to_segments(spelled_segment* segments, size_t capacity, uintmax_t value, unsigned options);
+#if RMGR_NSFR_HAS_INT128
+    size_t to_segments(spelled_segment* segments, size_t capacity, int128_t  value, unsigned options);
+    size_t to_segments(spelled_segment* segments, size_t capacity, uint128_t value, unsigned options);
+#endif
+}
+/** @endcond */
+
+
+/**
+ * @brief Spells out a number as segments pointing into the library's tables, without copying any text
+ *
+ * The segments remain valid until the program exits. A capacity of zero gives the count needed.
+ *
+ * @param segments Where to write the segments, at most @p capacity of them
+ *
+ * @return The number of segments the spelling takes, which were all written if no greater than @p capacity
+ */
+template<typename T>
+size_t to_segments(spelled_segment* segments, size_t capacity, T value, unsigned options = 0)
+{
+    return internal::to_segments(segments, capacity, typename internal::Widest<T>::type(value), options);
+}
+
+
+//=================================================================================================
+// Normalization
+
+/**
+ * @brief Rewrites the numbers of a French text as words, the text being fed in chunks of any size
+ *
+ * Every run of digits is replaced by its spelling, along with:
+ * - a leading '-' that doesn't follow a letter or a digit ("-12" is "moins douze", "10-12" is not negative),
+ * - thousands separators, be they spaces, no-break spaces or narrow no-break spaces ("1 000 000"),
+ *   as long as all groups but the first one have exactly 3 digits,
+ * - ordinal abbreviations that are not followed by a letter: "1er", "1re", "1\xC3\xA8re", "2nd",
+ *   "2nde", and "e", "\xC3\xA8me", "eme", "i\xC3\xA8me" or "ieme" after any other number.
+ *
+ * Whatever else goes through unchanged, in as few writes as possible. The bytes that may belong to
+ * a number are held back until it is known where the number ends, so a number may straddle chunks.
+ * The text is assumed to be UTF-8, or at least ASCII-compatible.
+ */
+class normalizer
+{
+public:
+    /**
+     * @param write   Receives the normalized text piece by piece
+     * @param options The gender and variants to spell numbers with (e.g. `BELGIUM`), ordinal
+     *                abbreviations adding `ORDINAL` and the like on top of them
+     */
+    normalizer(write_function write, void* context, unsigned options = 0);
+
+    /** @brief Normalizes the next chunk of text */
+    void feed(const char* data, size_t size);
+
+    /** @brief Writes what was held back at the end of the text, after which a new text may be fed */
+    void finish();
+
+private:
+    enum State
+    {
+        TEXT,      ///< Outside of any number
+        DIGITS,    ///< In the digits of a number
+        SEPARATOR, ///< In what may be a thousands separator
+        SUFFIX     ///< In what may be an ordinal abbreviation
+    };
+
+    void        process(const char* first, const char* last);
+    const char* process_text(const char* first, const char* last);
+    bool        process_byte(int c);
+    void        begin_number(bool negative);
+    void        end_number(unsigned flags);
+    void        roll_back();
+    void        write(const char* str, size_t length);
+
+    write_function m_write;
+    void*          m_context;
+    unsigned       m_options;
+    State          m_state;
+    bool           m_negative;      ///< Whether the number starts with '-'
+    bool           m_minusHeld;     ///< Whether a '-' ending the previous chunk is held back
+    unsigned char  m_previous;      ///< The last byte of the text written, to tell whether a '-' is a sign
+    unsigned char  m_separator;     ///< The first byte of the thousands separators of the number, 0 until one is met
+    size_t         m_groupLength;   ///< The number of digits of the group being read
+    size_t         m_committed;     ///< The length of `m_pending` known to belong to the number
+    std::string    m_pending;       ///< The bytes held back: the number, then what may extend it
+    std::string    m_spelling;
+};
+
+
+/**
+ * @brief Normalizes a whole text at once, see `normalizer`
+ */
+inline std::string normalize(const char* first, const char* last, unsigned options = 0)
+{
+    std::string str;
+    str.reserve(size_t(last - first));
+    normalizer norm([](void* context, const char* s, size_t length)
+    {
+        static_cast<std::string*>(context)->append(s, length);
+    }, &str, options);
+    norm.feed(first, size_t(last - first));
+    norm.finish();
+    return str;
+}
+
+
+#if RMGR_NSFR_HAS_STRING_VIEW
+inline std::string normalize(std::string_view text, unsigned options = 0)
+{
+    return normalize(text.data(), text.data() + text.size(), options);
+}
+#endif
+
+
+//=================================================================================================
+// Scanning
+
+/**
+ * @brief A number spelled out in a text, as found by `scanner`
+ */
+struct spelled_number
+{
+    uint64_t  offset;   ///< Where the first word of the number starts within the text, in bytes
+    size_t    length;   ///< The length in bytes, from the first word of the number to the end of its last one
+    std::errc ec;       ///< `std::errc()`, or `std::errc::result_out_of_range` if the number is too large
+    uintmax_t value;    ///< The absolute value of the number, 0 if too large
+    bool      negative; ///< Whether the number is preceded by "moins"
+    unsigned  options;  ///< How the number is spelled: type, gender and variants, like `parse()` reports them
+};
+
+
+/**
+ * @brief Receives the numbers a `scanner` finds, in order
+ */
+typedef void (*found_function)(void* context, const spelled_number& number);
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    struct ScannerState;
+}
+/** @endcond */
+
+
+/**
+ * @brief Finds the numbers spelled out in a UTF-8 text, the text being fed in chunks of any size
+ *
+ * Words are recognized by a single automaton built from the tables numbers are spelled out with,
+ * ASCII and accented letters being matched in any case. They then go through the rules of
+ * `parse()`, so a number is the longest run of words that `parse()` would read in one go, its
+ * words being separated by a single space or hyphen. Every byte is looked at once, no text is held
+ * back, and a number is reported as soon as the next word or separator shows it has ended.
+ *
+ * Words that are also common words are reported like any other, "un" in "un chat" being a number.
+ */
+class scanner
+{
+public:
+    scanner(found_function found, void* context);
+    ~scanner();
+
+    scanner(const scanner&)            = delete;
+    scanner& operator=(const scanner&) = delete;
+
+    /** @brief Scans the next chunk of text */
+    void feed(const char* data, size_t size);
+
+    /** @brief Reports the number ending the text if any, after which a new text may be fed */
+    void finish();
+
+private:
+    std::unique_ptr<internal::ScannerState> m_state;
+};
+
+
+/**
+ * @brief Finds all the numbers spelled out in a whole text at once, see `scanner`
+ */
+inline std::vector<spelled_number> scan(const char* first, const char* last)
+{
+    std::vector<spelled_number> numbers;
+    scanner reader([](void* context, const spelled_number& number)
+    {
+        static_cast<std::vector<spelled_number>*>(context)->push_back(number);
+    }, &numbers);
+    reader.feed(first, size_t(last - first));
+    reader.finish();
+    return numbers;
+}
+
+
+#if RMGR_NSFR_HAS_STRING_VIEW
+inline std::vector<spelled_number> scan(std::string_view text)
+{
+    return scan(text.data(), text.data() + text.size());
+}
+#endif
+
+
+//=================================================================================================
+// Validation
+
+/**
+ * @brief Why a candidate spelling differs from the actual one, see `check_spelling()`
+ */
+enum class mismatch : uint8_t
+{
+    none,           ///< The candidate is the spelling
+    missing_plural, ///< The candidate lacks a plural "s" ("quatre-vingt" for 80)
+    extra_plural,   ///< The candidate has a plural "s" where there is none ("deux cents un", "deux milles")
+    et,             ///< The candidate lacks an "et", or has one where a hyphen is expected ("vingt-un", "vingt et deux")
+    joiner,         ///< The candidate has a space instead of a hyphen, or the other way round ("quatre vingts")
+    gender,         ///< The candidate has the wrong gender of "un", "premier" or "second"
+    truncated,      ///< The candidate is only the beginning of the spelling
+    trailing,       ///< The candidate goes on after the spelling
+    other           ///< Any other difference, such as a misspelled word
+};
+
+
+/**
+ * @brief The result of `check_spelling()`
+ */
+struct match_result
+{
+    size_t   offset; ///< Where the candidate starts to differ from the spelling, its length if it doesn't
+    mismatch reason;
+};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    bool         matches(intmax_t  value, unsigned options, const char* first, const char* last);
+    bool         matches(uintmax_t value, unsigned options, const char* first, const char* last);
+    match_result check_spelling(intmax_t  value, unsigned options, const char* first, const char* last);
+    match_result check_spelling(uintmax_t value, unsigned options, const char* first, const char* last);
+#if RMGR_NSFR_HAS_INT128
+    bool         matches(int128_t  value, unsigned options, const char* first, const char* last);
+    bool         matches(uint128_t value, unsigned options, const char* first, const char* last);
+    match_result check_spelling(int128_t  value, unsigned options, const char* first, const char* last);
+    match_result check_spelling(uint128_t value, unsigned options, const char* first, const char* last);
+#endif
+}
+/** @endcond */
+
+
+/**
+ * @brief Tells whether [@p first; @p last) is the spelling of a number, without spelling it out
+ *
+ * The candidate is compared with the spelling piece by piece as the spelling is produced, which
+ * stops at the first difference. No memory is allocated.
+ */
+template<typename T>
+bool matches(T value, unsigned options, const char* first, const char* last)
+{
+    return internal::matches(typename internal::Widest<T>::type(value), options, first, last);
+}
+
+
+/**
+ * @brief Compares [@p first; @p last) with the spelling of a number, telling where and why they differ
+ *
+ * The reason is that of the first difference only. No memory is allocated.
+ */
+template<typename T>
+match_result check_spelling(T value, unsigned options, const char* first, const char* last)
+{
+    return internal::check_spelling(typename internal::Widest<T>::type(value), options, first, last);
+}
+
+
+#if RMGR_NSFR_HAS_STRING_VIEW
+template<typename T>
+bool matches(T value, unsigned options, std::string_view candidate)
+{
+    return matches(value, options, candidate.data(), candidate.data() + candidate.size());
+}
+
+
+template<typename T>
+match_result check_spelling(T value, unsigned options, std::string_view candidate)
+{
+    return check_spelling(value, options, candidate.data(), candidate.data() + candidate.size());
+}
+#endif
+
+
+//=================================================================================================
+// Autocompletion
+
+/**
+ * @brief A range of values, both ends included
+ */
+struct value_range
+{
+    uintmax_t first;
+    uintmax_t last;
+};
+
+
+/**
+ * @brief What a partial spelling may be completed into, see `completion_index`
+ */
+struct completions
+{
+    std::vector<value_range> values; ///< The values whose spelling starts with the prefix, sorted, neither overlapping nor adjacent
+    std::vector<std::string> words;  ///< The words that complete the last word of the prefix, which may be partial or empty, sorted
+};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    struct CompletionIndex;
+}
+/** @endcond */
+
+
+/**
+ * @brief Finds the numbers whose spelling starts with a prefix, such as "quatre-vingt-d"
+ *
+ * The index follows the grammar of the spellings rather than enumerating them: it holds the groups
+ * of [1;999] sorted by spelling for each of the tables the profile of the options uses, a few
+ * kilobytes in all, and a lookup matches the prefix group after group, from the most significant
+ * one, by binary searches. The values are therefore reported as ranges, "deux mille" being
+ * followed by [2000;2999] and not by a thousand values.
+ *
+ * Words are separated by a space or a hyphen, and the prefix is matched byte for byte, so it must
+ * be in lowercase and have its accents. Only non-negative values are indexed, and `ORDINAL_SUFFIX`
+ * is ignored.
+ */
+class completion_index
+{
+public:
+    explicit completion_index(unsigned options=0);
+    ~completion_index();
+
+    completion_index(const completion_index&)            = delete;
+    completion_index& operator=(const completion_index&) = delete;
+
+    /** @brief Looks [@p first; @p last) up, reusing the memory of @p result */
+    void lookup(const char* first, const char* last, completions& result) const;
+
+    completions lookup(const char* first, const char* last) const
+    {
+        completions result;
+        lookup(first, last, result);
+        return result;
+    }
+
+#if RMGR_NSFR_HAS_STRING_VIEW
+    void        lookup(std::string_view prefix, completions& result) const {lookup(prefix.data(), prefix.data() + prefix.size(), result);}
+    completions lookup(std::string_view prefix) const                      {return lookup(prefix.data(), prefix.data() + prefix.size());}
+#endif
+
+private:
+    std::unique_ptr<internal::CompletionIndex> m_index;
+};
+
+
+//=================================================================================================
+// Collation
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    int      compare_spelled(intmax_t  a, intmax_t  b, unsigned options);
+    int      compare_spelled(uintmax_t a, uintmax_t b, unsigned options);
+    uint64_t spelled_sort_key(intmax_t  value, unsigned options);
+    uint64_t spelled_sort_key(uintmax_t value, unsigned options);
+#if RMGR_NSFR_HAS_INT128
+    int      compare_spelled(int128_t  a, int128_t  b, unsigned options);
+    int      compare_spelled(uint128_t a, uint128_t b, unsigned options);
+    uint64_t spelled_sort_key(int128_t  value, unsigned options);
+    uint64_t spelled_sort_key(uint128_t value, unsigned options);
+#endif
+}
+/** @endcond */
+
+
+/**
+ * @brief Compares two numbers by their spellings, like `memcmp()` would
+ *
+ * The spellings are collated letter by letter, case being ignored and the accented letters of
+ * the Latin-1 supplement weighing as their base letter (so "millieme" comes before "millionieme"
+ * even with its accent), while spaces and hyphens weigh alike, less than any letter. Spellings
+ * that only differ by their accents or separators are then ordered by their UTF-8 bytes.
+ *
+ * The pieces of the spellings point into the word and group tables rather than being copied, and
+ * they are compared as the second spelling is produced, which stops at the first difference. No
+ * memory is allocated.
+ *
+ * @return A negative value if the spelling of @p a comes first, 0 if @p a equals @p b, a positive value otherwise
+ */
+template<typename T>
+int compare_spelled(T a, T b, unsigned options=0)
+{
+    typedef typename internal::Widest<T>::type Widest;
+    return internal::compare_spelled(Widest(a), Widest(b), options);
+}
+
+
+/**
+ * @brief Computes a key made of the collation weights of the first 12 letters of the spelling
+ *
+ * The weights are those of `compare_spelled()`, of 5 bits each, the most significant first. Keys
+ * therefore compare as the beginnings of the spellings do: a key less than another one means the
+ * same order for the numbers, while equal keys mean `compare_spelled()` has to tell them apart.
+ * They are meant for radix sorts, or to sort pairs of keys and numbers before refining the runs
+ * of equal keys.
+ */
+template<typename T>
+uint64_t spelled_sort_key(T value, unsigned options=0)
+{
+    return internal::spelled_sort_key(typename internal::Widest<T>::type(value), options);
+}
 
 
 }} // namespace rmgr::nsfr
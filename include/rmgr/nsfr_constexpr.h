@@ -0,0 +1,817 @@
+/*
+ * Copyright (c) 2020, Romain Bailly
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#ifndef RMGR_NSFR_CONSTEXPR_H
+#define RMGR_NSFR_CONSTEXPR_H
+
+
+#include <rmgr/nsfr.h>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+
+#if RMGR_NSFR_CPLUSPLUS >= 201402L
+    #define RMGR_NSFR_CONSTEXPR14 constexpr
+#else
+    #define RMGR_NSFR_CONSTEXPR14 inline
+#endif
+
+
+namespace rmgr { namespace nsfr
+{
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+
+
+//=================================================================================================
+// Data
+
+/**
+ * @brief Where each word lies within the pool, as one `char` array per token
+ */
+struct WordLayout
+{
+#define RMGR_NSFR_WORD_FIELD(name, text) char name[sizeof(text) - 1];
+    RMGR_NSFR_TOKEN_LIST(RMGR_NSFR_WORD_FIELD)
+#undef RMGR_NSFR_WORD_FIELD
+};
+
+
+/**
+ * @brief Reference to a word of the pool
+ *
+ * Its length being known, appending it is a plain copy, and tables of these need no relocation.
+ */
+struct WordRef
+{
+    uint16_t offset;
+    uint8_t  length;
+    uint8_t  id;     ///< The `token` it stands for
+};
+
+#define RMGR_NSFR_WORD(name) {static_cast<uint16_t>(offsetof(WordLayout, name)), static_cast<uint8_t>(sizeof(WordLayout::name)), static_cast<uint8_t>(token::name)}
+
+
+/**
+ * @brief All the words numbers are made of
+ *
+ * This is a template only so that the tables can be defined in a header with a single instance.
+ */
+template<typename Dummy = void>
+struct WordTables
+{
+    struct Numeral
+    {
+        largest_uint_t value;     ///< The value
+        WordRef        cardinal;
+    };
+
+#define RMGR_NSFR_WORD_TEXT(name, text) text
+    static constexpr char pool[sizeof(WordLayout) + 1] = RMGR_NSFR_TOKEN_LIST(RMGR_NSFR_WORD_TEXT); // All the words, back to back
+#undef RMGR_NSFR_WORD_TEXT
+
+#define RMGR_NSFR_WORD_ENTRY(name, text) RMGR_NSFR_WORD(name),
+    static constexpr WordRef tokens[] = {RMGR_NSFR_TOKEN_LIST(RMGR_NSFR_WORD_ENTRY)}; // Indexed by token
+#undef RMGR_NSFR_WORD_ENTRY
+
+    static constexpr WordRef cardinals[16] = // Table of cardinals up to 16
+    {
+        RMGR_NSFR_WORD(UN),     RMGR_NSFR_WORD(DEUX),     RMGR_NSFR_WORD(TROIS),  RMGR_NSFR_WORD(QUATRE), //  1  2  3  4
+        RMGR_NSFR_WORD(CINQ),   RMGR_NSFR_WORD(SIX),      RMGR_NSFR_WORD(SEPT),   RMGR_NSFR_WORD(HUIT),   //  5  6  7  8
+        RMGR_NSFR_WORD(NEUF),   RMGR_NSFR_WORD(DIX),      RMGR_NSFR_WORD(ONZE),   RMGR_NSFR_WORD(DOUZE),  //  9 10 11 12
+        RMGR_NSFR_WORD(TREIZE), RMGR_NSFR_WORD(QUATORZE), RMGR_NSFR_WORD(QUINZE), RMGR_NSFR_WORD(SEIZE)   // 13 14 15 16
+    };
+
+    static constexpr WordRef ordinals[16] = // Table of ordinals up to 16
+    {
+        RMGR_NSFR_WORD(UNIEME),    RMGR_NSFR_WORD(DEUXIEME),    RMGR_NSFR_WORD(TROISIEME), RMGR_NSFR_WORD(QUATRIEME), //  1st  2nd  3rd  4th
+        RMGR_NSFR_WORD(CINQUIEME), RMGR_NSFR_WORD(SIXIEME),     RMGR_NSFR_WORD(SEPTIEME),  RMGR_NSFR_WORD(HUITIEME),  //  5th  6th  7th  8th
+        RMGR_NSFR_WORD(NEUVIEME),  RMGR_NSFR_WORD(DIXIEME),     RMGR_NSFR_WORD(ONZIEME),   RMGR_NSFR_WORD(DOUZIEME),  //  9th 10th 11th 12th
+        RMGR_NSFR_WORD(TREIZIEME), RMGR_NSFR_WORD(QUATORZIEME), RMGR_NSFR_WORD(QUINZIEME), RMGR_NSFR_WORD(SEIZIEME)   // 13th 14th 15th 16th
+    };
+
+    static constexpr WordRef cardinalTens[9] = // Table of cardinals for tens
+    {
+        RMGR_NSFR_WORD(DIX),      RMGR_NSFR_WORD(VINGT),     RMGR_NSFR_WORD(TRENTE),   // 10 20 30
+        RMGR_NSFR_WORD(QUARANTE), RMGR_NSFR_WORD(CINQUANTE), RMGR_NSFR_WORD(SOIXANTE), // 40 50 60
+        RMGR_NSFR_WORD(SEPTANTE), RMGR_NSFR_WORD(HUITANTE),  RMGR_NSFR_WORD(NONANTE)   // 70 80 90
+    };
+
+    static constexpr WordRef ordinalsTens[9] = // Table of ordinals for tens
+    {
+        RMGR_NSFR_WORD(DIXIEME),     RMGR_NSFR_WORD(VINGTIEME),    RMGR_NSFR_WORD(TRENTIEME),   // 10th 20th 30th
+        RMGR_NSFR_WORD(QUARANTIEME), RMGR_NSFR_WORD(CINQUANTIEME), RMGR_NSFR_WORD(SOIXANTIEME), // 40th 50th 60th
+        RMGR_NSFR_WORD(SEPTANTIEME), RMGR_NSFR_WORD(HUITANTIEME),  RMGR_NSFR_WORD(NONANTIEME)   // 70th 80th 90th
+    };
+
+    static constexpr Numeral numerals[] = // Table of other numerals
+    {
+        {       100, RMGR_NSFR_WORD(NUMERAL_CENT)},
+        {      1000, RMGR_NSFR_WORD(NUMERAL_MILLE)},
+        {   1000000, RMGR_NSFR_WORD(NUMERAL_MILLION)},
+        {1000000000, RMGR_NSFR_WORD(NUMERAL_MILLIARD)},
+
+    // 64-bit values
+    #ifdef UINT64_C
+        {UINT64_C(      1000000000000), RMGR_NSFR_WORD(NUMERAL_BILLION)},  // 10^12
+        {UINT64_C(   1000000000000000), RMGR_NSFR_WORD(NUMERAL_BILLIARD)}, // 10^15
+        {UINT64_C(1000000000000000000), RMGR_NSFR_WORD(NUMERAL_TRILLION)}, // 10^18
+    #endif
+
+    // 128-bit values (10^39 doesn't fit, hence no "sextilliard")
+    #if RMGR_NSFR_HAS_INT128
+        {uint128_t(UINT64_C(1000000000000000000)) * UINT64_C(1000),                RMGR_NSFR_WORD(NUMERAL_TRILLIARD)},    // 10^21
+        {uint128_t(UINT64_C(1000000000000000000)) * UINT64_C(1000000),             RMGR_NSFR_WORD(NUMERAL_QUADRILLION)},  // 10^24
+        {uint128_t(UINT64_C(1000000000000000000)) * UINT64_C(1000000000),          RMGR_NSFR_WORD(NUMERAL_QUADRILLIARD)}, // 10^27
+        {uint128_t(UINT64_C(1000000000000000000)) * UINT64_C(1000000000000),       RMGR_NSFR_WORD(NUMERAL_QUINTILLION)},  // 10^30
+        {uint128_t(UINT64_C(1000000000000000000)) * UINT64_C(1000000000000000),    RMGR_NSFR_WORD(NUMERAL_QUINTILLIARD)}, // 10^33
+        {uint128_t(UINT64_C(1000000000000000000)) * UINT64_C(1000000000000000000), RMGR_NSFR_WORD(NUMERAL_SEXTILLION)},   // 10^36
+    #endif
+    };
+
+    static constexpr WordRef joiners[2] = {RMGR_NSFR_WORD(JOIN_HYPHEN), RMGR_NSFR_WORD(JOIN_ET)};
+    static constexpr WordRef first[2]   = {RMGR_NSFR_WORD(PREMIER),     RMGR_NSFR_WORD(PREMIERE)};
+    static constexpr WordRef second[2]  = {RMGR_NSFR_WORD(SECOND),      RMGR_NSFR_WORD(SECONDE)};
+};
+
+template<typename Dummy> constexpr char                                      WordTables<Dummy>::pool[sizeof(WordLayout) + 1];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::tokens[];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::cardinals[16];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::ordinals[16];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::cardinalTens[9];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::ordinalsTens[9];
+template<typename Dummy> constexpr typename WordTables<Dummy>::Numeral       WordTables<Dummy>::numerals[];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::joiners[2];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::first[2];
+template<typename Dummy> constexpr WordRef                                   WordTables<Dummy>::second[2];
+
+typedef WordTables<> Words;
+
+constexpr WordRef g_zero            = RMGR_NSFR_WORD(ZERO);
+constexpr WordRef g_zeroieme        = RMGR_NSFR_WORD(ZEROIEME);
+constexpr WordRef g_oneFeminine     = RMGR_NSFR_WORD(UNE);
+constexpr WordRef g_space           = RMGR_NSFR_WORD(JOIN_SPACE);
+constexpr WordRef g_ordinalEnding   = RMGR_NSFR_WORD(ORDINAL_IEME);
+constexpr WordRef g_octante         = RMGR_NSFR_WORD(OCTANTE);
+constexpr WordRef g_octanteOrdinal  = RMGR_NSFR_WORD(OCTANTIEME);
+constexpr WordRef g_millieme        = RMGR_NSFR_WORD(NUMERAL_MILLIEME);
+constexpr WordRef g_plural          = RMGR_NSFR_WORD(PLURAL_S);
+constexpr WordRef g_minus           = RMGR_NSFR_WORD(MOINS);
+constexpr WordRef g_suffix          = RMGR_NSFR_WORD(SUFFIX_E);
+constexpr WordRef g_suffixFirst[2]  = {RMGR_NSFR_WORD(SUFFIX_ER), RMGR_NSFR_WORD(SUFFIX_RE)};
+constexpr WordRef g_suffixSecond[2] = {RMGR_NSFR_WORD(SUFFIX_D),  RMGR_NSFR_WORD(SUFFIX_DE)};
+
+constexpr unsigned TYPE_MASK      = CARDINAL | ORDINAL | CARDINAL_AS_ORDINAL | ORDINAL_SUFFIX;
+constexpr unsigned PLURAL_ALLOWED = 0x1000;
+
+constexpr unsigned MAX_GROUP_COUNT = (sizeof(largest_uint_t) * 8 + 9) / 10 + 1; // 1000 ~ 2^10
+
+
+//=================================================================================================
+// Sinks
+
+RMGR_NSFR_CONSTEXPR14 size_t string_length(const char* str)
+{
+#if RMGR_NSFR_CPLUSPLUS >= 201703L
+    return std::char_traits<char>::length(str);
+#else
+    size_t length = 0;
+    while (str[length] != '\0')
+        ++length;
+    return length;
+#endif
+}
+
+
+/**
+ * @brief Sink that only keeps track of the length
+ */
+struct CountingSink
+{
+    size_t length;
+
+    constexpr CountingSink(): length(0) {}
+
+    RMGR_NSFR_CONSTEXPR14 void append(const char*, size_t length_) {length += length_;}
+    RMGR_NSFR_CONSTEXPR14 void append(const char* s)               {length += string_length(s);}
+    RMGR_NSFR_CONSTEXPR14 void append(WordRef word)                {length += word.length;}
+    RMGR_NSFR_CONSTEXPR14 void append(char)                        {++length;}
+};
+
+
+/**
+ * @brief Sink that writes into a buffer known to be large enough, usable at compile time
+ */
+struct UncheckedSink
+{
+    char* cur;
+
+    constexpr explicit UncheckedSink(char* first): cur(first) {}
+
+    RMGR_NSFR_CONSTEXPR14 void append(const char* s, size_t length) {for (size_t i = 0; i < length; ++i) *cur++ = s[i];}
+    RMGR_NSFR_CONSTEXPR14 void append(const char* s)                {while (*s != '\0') *cur++ = *s++;}
+    RMGR_NSFR_CONSTEXPR14 void append(WordRef word)                 {append(Words::pool + word.offset, word.length);}
+    RMGR_NSFR_CONSTEXPR14 void append(char c)                       {*cur++ = c;}
+};
+
+
+//=================================================================================================
+// Rules
+
+/**
+ * @brief Retrieves the names for values within [1;16]
+ */
+RMGR_NSFR_CONSTEXPR14 WordRef format_below17(unsigned value, unsigned options)
+{
+    assert(1<=value && value<=16);
+    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+
+    if (options & ORDINAL)
+        return Words::ordinals[value-1];
+    else if (value==1u && (options & FEMININE))
+        return g_oneFeminine;
+    else
+        return Words::cardinals[value-1];
+}
+
+
+/**
+ * @brief Retrieves the names for tens units
+ */
+RMGR_NSFR_CONSTEXPR14 WordRef format_tens(unsigned tens, unsigned options)
+{
+    assert(1<=tens && tens<=9);
+    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+
+    if (options & ORDINAL)
+    {
+        if (tens==8u && (options & OCTANTE))
+            return g_octanteOrdinal;
+        return Words::ordinalsTens[tens-1];
+    }
+    else
+    {
+        if (tens==8u && (options & OCTANTE))
+            return g_octante;
+        return Words::cardinalTens[tens-1];
+    }
+}
+
+
+template<typename Sink, typename Uint>
+RMGR_NSFR_CONSTEXPR14 void recursive_format(Sink& sink, Uint value, unsigned options);
+
+
+/**
+ * @brief Special handling of numbers between 70 and 99 for reference French
+ */
+template<typename Sink>
+RMGR_NSFR_CONSTEXPR14 void format70_99(Sink& sink, unsigned value, unsigned options)
+{
+    assert(70<=value && value<=99);
+    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+
+    if (value <= 79)              // 70-79 with a special case at 71
+    {
+        sink.append(Words::cardinalTens[5]);       // Based on "soixante"
+        sink.append(Words::joiners[value == 71u]); // 71 doesn't take an hyphen but "et" instead
+        recursive_format(sink, value-60, (options & ~PLURAL_ALLOWED));
+    }
+    else                         // 80-99
+    {
+        sink.append(Words::cardinals[3]);    // "quatre-vingt"
+        sink.append(Words::joiners[0]);
+        sink.append(Words::cardinalTens[1]);
+        if (value == 80u)
+        {
+            if (options & ORDINAL)              // Add the ordinal ending
+                sink.append(g_ordinalEnding);
+            else if (options & PLURAL_ALLOWED)  // When allowed to, append the 's' for plural
+                sink.append(g_plural);
+        }
+        else
+        {
+            sink.append(Words::joiners[0]);
+            recursive_format(sink, value-80, (options & ~PLURAL_ALLOWED));
+        }
+    }
+}
+
+
+/**
+ * @brief Recursive formatting function
+ *
+ * This is the straight application of the rules. It is used as is for numbers below 1000, and as
+ * the reference iterative_format() must abide by for the others.
+ *
+ * @param sink    Where to write the resulting formatted text
+ * @param value   The number to format, of any unsigned type
+ * @param options The formatting options (type, gender, variant and whether plural is allowed,
+ *                which it is not when dealing with ordinals)
+ */
+template<typename Sink, typename Uint>
+RMGR_NSFR_CONSTEXPR14 void recursive_format(Sink& sink, Uint value, unsigned options)
+{
+    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+
+    if (value < 17u)                                     // 1 - 16
+        sink.append(format_below17(static_cast<unsigned>(value), options));
+    else if (value < 100u)                               // 17 - 99
+    {
+        if (   (value <= 69u)
+            || (value <= 79u && (options & SEPTANTE))
+            || (value <= 89u && (options & (HUITANTE | OCTANTE)))
+            || (options & NONANTE))
+        {
+            const unsigned tens = static_cast<unsigned>(value / 10u);
+            const unsigned ones = static_cast<unsigned>(value % 10u);
+            if (ones == 0u)
+                sink.append(format_tens(tens, options));
+            else
+            {
+                sink.append(format_tens(tens, ((options & ~TYPE_MASK) | CARDINAL)));
+                sink.append(Words::joiners[ones == 1u]);
+                sink.append(format_below17(ones, options));
+            }
+        }
+        else                                             // 70 - 99 for reference French
+            format70_99(sink, static_cast<unsigned>(value), options);
+    }
+    else                                                 // 100 - ...
+    {
+        const typename Words::Numeral* numeral = &Words::numerals[0];
+        // Force the use of "cent" for [1100; 1999]
+        if ((options & CENT_1100_1999) && 1100<=value && value<=1999)
+            numeral = &Words::numerals[0];
+        // Regular case: find the appropriate numeral
+        else
+        {
+            const size_t numeralCount = sizeof(Words::numerals) / sizeof(Words::numerals[0]);
+            size_t i = 0;
+            while (i < numeralCount && Words::numerals[i].value <= value)
+                ++i;
+            numeral = &Words::numerals[i-1];
+        }
+
+        // Compute the multiplier & remainder (the numeral is no greater than the value, hence fits in Uint)
+        const Uint multiplier = value / static_cast<Uint>(numeral->value);
+        const Uint remainder  = value % static_cast<Uint>(numeral->value);
+
+        // Check the numeral's properties
+        const bool isNoun    = (numeral->value > 1000u && !((options & ORDINAL) && remainder==0u));
+        const bool hasPlural = (numeral->value != 1000u);
+
+        // Add the multiplier (if needed)
+        if (multiplier>1u || isNoun)
+        {
+            unsigned newOptions = options & ~(TYPE_MASK | FEMININE); // Force masculine cardinal
+            if (!isNoun)
+                newOptions &= ~PLURAL_ALLOWED;
+            recursive_format(sink, multiplier, newOptions);
+            sink.append(g_space);
+        }
+
+        // The numeral itself (with the plural form if needed)
+        if ((options & ORDINAL) && !remainder)
+        {
+            if (numeral->value == 1000u)
+                sink.append(g_millieme);
+            else
+            {
+                sink.append(numeral->cardinal);
+                sink.append(g_ordinalEnding);
+            }
+        }
+        else
+        {
+            sink.append(numeral->cardinal);
+            if (multiplier>1u && (isNoun || ((options & PLURAL_ALLOWED) && hasPlural && !remainder)))
+                sink.append(g_plural);
+        }
+
+        // The remainder if any
+        if (remainder)
+        {
+            sink.append(g_space);
+            recursive_format(sink, remainder, options);
+        }
+    }
+}
+
+
+/**
+ * @brief Splits a number into base-1000 groups, the least significant one first
+ *
+ * @param count The number of groups already stored into @p groups
+ *
+ * @return The total number of groups
+ */
+RMGR_NSFR_CONSTEXPR14 unsigned split_groups(uintmax_t value, unsigned (&groups)[MAX_GROUP_COUNT], unsigned count = 0)
+{
+    // The divisions by the constant 1000 are turned into multiplications & shifts by the compiler,
+    // these are even cheaper once the value fits in 32 bits
+    while (value > UINT32_MAX)
+    {
+        groups[count++] = static_cast<unsigned>(value % 1000u);
+        value /= 1000u;
+    }
+    uint32_t value32 = static_cast<uint32_t>(value);
+    do
+    {
+        groups[count++] = value32 % 1000u;
+        value32 /= 1000u;
+    }
+    while (value32 != 0u);
+    return count;
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+RMGR_NSFR_CONSTEXPR14 unsigned split_groups(uint128_t value, unsigned (&groups)[MAX_GROUP_COUNT])
+{
+    // 128-bit divisions are library calls, so only use them to split the value into 18-digit
+    // chunks (at most 2), whose groups are then split with 64-bit arithmetic
+    unsigned count = 0;
+    while (value > UINT64_MAX)
+    {
+        const uint64_t  e18      = UINT64_C(1000000000000000000);
+        const uint128_t quotient = value / e18;
+        uint64_t        chunk    = static_cast<uint64_t>(value - quotient * e18);
+        for (unsigned i = 0; i < 6u; ++i)
+        {
+            groups[count++] = static_cast<unsigned>(chunk % 1000u);
+            chunk /= 1000u;
+        }
+        value = quotient;
+    }
+    return split_groups(static_cast<uint64_t>(value), groups, count);
+}
+#endif
+
+
+/**
+ * @brief The base-1000 groups of a native integer, split once
+ *
+ * Along with format_groups(), splitting the number and naming the groups are kept apart from the
+ * rules, so that other sources of groups (e.g. strings of digits) can share them.
+ */
+struct IntegerGroups
+{
+    unsigned values[MAX_GROUP_COUNT];
+    unsigned count;
+
+    template<typename Uint>
+    RMGR_NSFR_CONSTEXPR14 explicit IntegerGroups(Uint value):
+        values(),
+        count(split_groups(value, values))
+    {
+    }
+
+    RMGR_NSFR_CONSTEXPR14 size_t size() const {return count;}
+
+    RMGR_NSFR_CONSTEXPR14 unsigned operator[](size_t i) const {return values[i];}
+
+    /** @brief Appends the noun of group @p i (million, milliard, ...) */
+    template<typename Sink>
+    RMGR_NSFR_CONSTEXPR14 void append_scale(Sink& sink, size_t i) const
+    {
+        sink.append(Words::numerals[i].cardinal);
+    }
+};
+
+
+/**
+ * @brief Formats a number given as base-1000 groups, from the most significant one
+ *
+ * @param groups Provides `size()`, `operator[]` (the least significant group first, the most
+ *               significant one being non-zero) and `append_scale()` (the nouns of groups 2+)
+ * @param engine Spells out the groups, i.e. numbers within [1;999], through `append_group()`
+ *               (the lowest group), `append_noun_multiplier()` (before million, milliard, ...) and
+ *               `append_adjective_multiplier()` (before mille, cent and the ordinal nouns). It is
+ *               told where the spelling of each non-zero group starts through `begin_group()`.
+ */
+template<typename Sink, typename Groups, typename Engine>
+RMGR_NSFR_CONSTEXPR14 void format_groups(Sink& sink, const Groups& groups, unsigned options, const Engine& engine)
+{
+    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+
+    // Below this group, there is no remainder anymore
+    size_t lowest = 0;
+    while (groups[lowest] == 0u)
+        ++lowest;
+
+    const unsigned nounOptions      = options & ~(TYPE_MASK | FEMININE); // Force masculine cardinal
+    const unsigned adjectiveOptions = nounOptions & ~PLURAL_ALLOWED;
+    for (size_t i = groups.size()-1; ; --i)
+    {
+        const unsigned group = groups[i];
+        if (group == 0u)
+            continue;
+        engine.begin_group(sink, i);
+
+        if (i == 0u)                                                // 1 - 999
+        {
+            engine.append_group(sink, group, options);
+            break;
+        }
+        else if (i == 1u)                                           // Thousands
+        {
+            // Force the use of "cent" for [1100; 1999]
+            if ((options & CENT_1100_1999) && group == 1u && groups[0] >= 100u)
+            {
+                const unsigned hundreds  = 10u + groups[0] / 100u;
+                const unsigned remainder = groups[0] % 100u;
+                engine.append_adjective_multiplier(sink, hundreds, adjectiveOptions);
+                sink.append(g_space);
+                sink.append(Words::numerals[0].cardinal);
+                if (remainder == 0u)
+                {
+                    if (options & ORDINAL)
+                        sink.append(g_ordinalEnding);
+                    else if (options & PLURAL_ALLOWED)
+                        sink.append(g_plural);
+                    break;
+                }
+                sink.append(g_space);
+                engine.append_group(sink, remainder, options);
+                break;
+            }
+
+            // "mille" is an invariable adjective
+            if (group > 1u)
+            {
+                engine.append_adjective_multiplier(sink, group, adjectiveOptions);
+                sink.append(g_space);
+            }
+            if ((options & ORDINAL) && lowest == 1u)
+                sink.append(g_millieme);
+            else
+                sink.append(Words::numerals[1].cardinal);
+        }
+        else                                                        // Nouns: million, milliard, ...
+        {
+            // The ordinal suffix turns the noun into an adjective
+            const bool isNoun = !((options & ORDINAL) && lowest == i);
+            if (isNoun)
+            {
+                engine.append_noun_multiplier(sink, group, nounOptions);
+                sink.append(g_space);
+            }
+            else if (group > 1u)
+            {
+                engine.append_adjective_multiplier(sink, group, adjectiveOptions);
+                sink.append(g_space);
+            }
+            groups.append_scale(sink, i);
+            if (!isNoun)
+                sink.append(g_ordinalEnding);
+            else if (group > 1u)
+                sink.append(g_plural);
+        }
+
+        if (lowest == i)
+            break;
+        sink.append(g_space);
+    }
+}
+
+
+/**
+ * @brief Iterative formatting function
+ *
+ * Splits the number into base-1000 groups once, then emits them from the most significant one.
+ * The output is identical to that of recursive_format() but stack usage is constant.
+ */
+template<typename Sink, typename Uint, typename Engine>
+RMGR_NSFR_CONSTEXPR14 void iterative_format(Sink& sink, Uint value, unsigned options, const Engine& engine)
+{
+    assert(value != 0u);
+    const IntegerGroups groups(value);
+    format_groups(sink, groups, options, engine);
+}
+
+
+/**
+ * @brief Engine that applies the rules to every group, usable at compile time
+ */
+struct RuleEngine
+{
+    template<typename Sink>
+    RMGR_NSFR_CONSTEXPR14 void begin_group(Sink&, size_t) const {}
+
+    template<typename Sink>
+    RMGR_NSFR_CONSTEXPR14 void append_group(Sink& sink, unsigned value, unsigned options) const
+    {
+        recursive_format(sink, value, options);
+    }
+
+    template<typename Sink>
+    RMGR_NSFR_CONSTEXPR14 void append_noun_multiplier(Sink& sink, unsigned value, unsigned options) const
+    {
+        recursive_format(sink, value, options);
+    }
+
+    template<typename Sink>
+    RMGR_NSFR_CONSTEXPR14 void append_adjective_multiplier(Sink& sink, unsigned value, unsigned options) const
+    {
+        recursive_format(sink, value, options);
+    }
+
+    template<typename Sink, typename Uint>
+    RMGR_NSFR_CONSTEXPR14 void format_number(Sink& sink, Uint value, unsigned options) const
+    {
+        iterative_format(sink, value, options, *this);
+    }
+};
+
+
+/**
+ * @brief Normalizes the options the way the formatting of numbers other than the special ones expects
+ *
+ * The type is reduced to either cardinal or ordinal, plural being allowed for true cardinals only.
+ */
+constexpr unsigned number_options(unsigned options)
+{
+    return ((options & (HUITANTE | OCTANTE)) == (HUITANTE | OCTANTE)) ? number_options(options & ~OCTANTE) // "huitante" overrides "octante"
+         : ((options & TYPE_MASK) == CARDINAL)                         ? (options | PLURAL_ALLOWED)
+         : (options & CARDINAL_AS_ORDINAL)                             ? (options & ~TYPE_MASK)
+         :                                                               options;
+}
+
+
+/**
+ * @brief Top-level formatting function, handles the special cases and the options
+ *
+ * @param engine Spells out numbers other than the special ones through `format_number()`
+ */
+template<typename Sink, typename Engine>
+RMGR_NSFR_CONSTEXPR14 void format(Sink& sink, uintmax_t value, unsigned options, const Engine& engine)
+{
+    if (options & ORDINAL_SUFFIX)
+    {
+        if (value == 1u)
+            sink.append(g_suffixFirst[options & FEMININE]);
+        else if (value==2u && (options & SECOND))
+            sink.append(g_suffixSecond[options & FEMININE]);
+        else
+            sink.append(g_suffix);
+    }
+    else if (value == 0u)
+        sink.append((options & ORDINAL) ? g_zeroieme : g_zero);
+    else if (value==1u && (options & ORDINAL))
+        sink.append(Words::first[options & FEMININE]);
+    else if (value==2u && ((options & (ORDINAL | SECOND)) == (ORDINAL | SECOND)))
+        sink.append(Words::second[options & FEMININE]);
+    else
+        engine.format_number(sink, value, number_options(options));
+}
+
+
+template<typename Sink, typename Engine>
+RMGR_NSFR_CONSTEXPR14 void format(Sink& sink, intmax_t value, unsigned options, const Engine& engine)
+{
+    assert(!(value<0 && (options & (ORDINAL | ORDINAL_SUFFIX))));
+
+    // Negating in the unsigned domain, as -INTMAX_MIN overflows
+    uintmax_t magnitude = static_cast<uintmax_t>(value);
+    if (value < 0)
+    {
+        sink.append(g_minus);
+        sink.append(g_space);
+        magnitude = 0u - magnitude;
+    }
+
+    format(sink, magnitude, options, engine);
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+template<typename Sink, typename Engine>
+RMGR_NSFR_CONSTEXPR14 void format(Sink& sink, uint128_t value, unsigned options, const Engine& engine)
+{
+    // Most values fit in 64 bits, which are much faster to process
+    if (value <= UINTMAX_MAX)
+        format(sink, static_cast<uintmax_t>(value), options, engine);
+    else if (options & ORDINAL_SUFFIX)
+        sink.append(g_suffix);
+    else
+        engine.format_number(sink, value, number_options(options));
+}
+
+
+template<typename Sink, typename Engine>
+RMGR_NSFR_CONSTEXPR14 void format(Sink& sink, int128_t value, unsigned options, const Engine& engine)
+{
+    assert(!(value<0 && (options & (ORDINAL | ORDINAL_SUFFIX))));
+
+    // Negating in the unsigned domain, as the opposite of the most negative value overflows
+    uint128_t magnitude = static_cast<uint128_t>(value);
+    if (value < 0)
+    {
+        sink.append(g_minus);
+        sink.append(g_space);
+        magnitude = 0u - magnitude;
+    }
+
+    format(sink, magnitude, options, engine);
+}
+#endif
+
+
+} // namespace internal
+/** @endcond */
+
+
+//=================================================================================================
+// Compile-time spelling
+
+#if RMGR_NSFR_CPLUSPLUS >= 201703L
+
+/**
+ * @brief A string of fixed length, usable at compile time
+ *
+ * It is null-terminated, so it can be used as a string literal.
+ */
+template<size_t N>
+struct fixed_string
+{
+    char chars[N + 1];
+
+    constexpr size_t      size()  const {return N;}
+    constexpr size_t      length()const {return N;}
+    constexpr const char* data()  const {return chars;}
+    constexpr const char* c_str() const {return chars;}
+    constexpr const char* begin() const {return chars;}
+    constexpr const char* end()   const {return chars + N;}
+
+    constexpr char operator[](size_t i) const {return chars[i];}
+
+#if RMGR_NSFR_HAS_STRING_VIEW
+    constexpr operator std::string_view() const {return std::string_view(chars, N);}
+#endif
+    operator std::string() const {return std::string(chars, N);}
+};
+
+
+/** @cond RmgrNsfrInternal */
+namespace internal
+{
+    template<auto Value, unsigned Options>
+    constexpr size_t constexpr_spelled_length()
+    {
+        CountingSink sink;
+        format(sink, typename Widest<decltype(Value)>::type(Value), Options, RuleEngine());
+        return sink.length;
+    }
+
+    template<auto Value, unsigned Options>
+    constexpr fixed_string<constexpr_spelled_length<Value, Options>()> make_spelled()
+    {
+        fixed_string<constexpr_spelled_length<Value, Options>()> result = {};
+        UncheckedSink sink(result.chars);
+        format(sink, typename Widest<decltype(Value)>::type(Value), Options, RuleEngine());
+        *sink.cur = '\0';
+        return result;
+    }
+}
+/** @endcond */
+
+
+/**
+ * @brief The spelling of a number, computed at compile time
+ *
+ * For instance, `spelled<80, ORDINAL|FEMININE>` is "quatre-vingtième". This is the very same
+ * rules as `spell_out()` but the string is a constant, thus has no runtime cost at all.
+ */
+template<auto Value, unsigned Options = 0>
+inline constexpr fixed_string<internal::constexpr_spelled_length<Value, Options>()> spelled = internal::make_spelled<Value, Options>();
+
+#endif // RMGR_NSFR_CPLUSPLUS >= 201703L
+
+
+}} // namespace rmgr::nsfr
+
+
+#endif // RMGR_NSFR_CONSTEXPR_H
@@ -52,347 +52,4194 @@
  */
 
 #include <rmgr/nsfr.h>
+#include <rmgr/nsfr_constexpr.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if RMGR_NSFR_CPLUSPLUS >= 201703L && defined(__has_include)
+    #if __has_include(<charconv>)
+        #include <charconv>
+    #endif
+#endif
+#if defined(__cpp_lib_to_chars)
+    #define RMGR_NSFR_HAS_TO_CHARS_DOUBLE 1
+#else
+    #define RMGR_NSFR_HAS_TO_CHARS_DOUBLE 0
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define RMGR_NSFR_HAS_AVX2 1
+#else
+    #define RMGR_NSFR_HAS_AVX2 0
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+    #define RMGR_NSFR_HAS_SSE2 1
+#else
+    #define RMGR_NSFR_HAS_SSE2 0
+#endif
 
 
 namespace rmgr { namespace nsfr
 {
 
+using internal::Words;
+using internal::WordRef;
+using internal::CountingSink;
+using internal::TYPE_MASK;
+using internal::PLURAL_ALLOWED;
+using internal::recursive_format;
+using internal::iterative_format;
+using internal::format;
+
+
 //=================================================================================================
-// Data
+// Word lengths
 
-// Table of cardinals up to 16
-static char const* const g_cardinals[16] =
+// max_spelled_length() can't see the pool, so it relies on lengths of its own, which must follow the words
+
+static constexpr bool same_lengths(const unsigned char* lengths, const WordRef* words, size_t count)
 {
-    "un",       "deux",     "trois",  "quatre",  //  1  2  3  4
-    "cinq",     "six",      "sept",   "huit",    //  5  6  7  8
-    "neuf",     "dix",      "onze",   "douze",   //  9 10 11 12
-    "treize",   "quatorze", "quinze", "seize"    // 13 14 15 16
-};
+    return count == 0u || (lengths[count-1] == words[count-1].length && same_lengths(lengths, words, count - 1u));
+}
+
+static_assert(same_lengths(internal::g_cardinalLengths,     Words::cardinals,    16), "g_cardinalLengths doesn't match the cardinals");
+static_assert(same_lengths(internal::g_ordinalLengths,      Words::ordinals,     16), "g_ordinalLengths doesn't match the ordinals");
+static_assert(same_lengths(internal::g_cardinalTensLengths, Words::cardinalTens,  9), "g_cardinalTensLengths doesn't match the tens");
+static_assert(same_lengths(internal::g_ordinalTensLengths,  Words::ordinalsTens,  9), "g_ordinalTensLengths doesn't match the ordinal tens");
+
+#define RMGR_NSFR_CHECK_LENGTH(length, name) static_assert((length) == sizeof(internal::WordLayout::name), "The length of " #name " is out of date");
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[0],  NUMERAL_CENT)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[1],  NUMERAL_MILLE)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[2],  NUMERAL_MILLION)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[3],  NUMERAL_MILLIARD)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[4],  NUMERAL_BILLION)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[5],  NUMERAL_BILLIARD)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[6],  NUMERAL_TRILLION)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[7],  NUMERAL_TRILLIARD)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[8],  NUMERAL_QUADRILLION)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[9],  NUMERAL_QUADRILLIARD)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[10], NUMERAL_QUINTILLION)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[11], NUMERAL_QUINTILLIARD)
+RMGR_NSFR_CHECK_LENGTH(internal::g_numeralLengths[12], NUMERAL_SEXTILLION)
+
+// The words below100_length(), group_length() and max_length() spell out as literals
+RMGR_NSFR_CHECK_LENGTH(3u,       UNE)
+RMGR_NSFR_CHECK_LENGTH(4u,       NUMERAL_CENT)
+RMGR_NSFR_CHECK_LENGTH(5u,       NUMERAL_MILLE)
+RMGR_NSFR_CHECK_LENGTH(5u,       ORDINAL_IEME)
+RMGR_NSFR_CHECK_LENGTH(7u,       OCTANTE)
+RMGR_NSFR_CHECK_LENGTH(11u,      OCTANTIEME)
+RMGR_NSFR_CHECK_LENGTH(8u,       SOIXANTE)
+RMGR_NSFR_CHECK_LENGTH(12u - 7u, VINGT)     // "quatre-vingt"
+RMGR_NSFR_CHECK_LENGTH(12u - 6u, QUATRE)
+RMGR_NSFR_CHECK_LENGTH(1u,       JOIN_HYPHEN)
+RMGR_NSFR_CHECK_LENGTH(1u,       JOIN_SPACE)
+RMGR_NSFR_CHECK_LENGTH(1u,       PLURAL_S)
+RMGR_NSFR_CHECK_LENGTH(4u,       JOIN_ET)
+RMGR_NSFR_CHECK_LENGTH(6u - 1u,  MOINS)     // "moins "
+RMGR_NSFR_CHECK_LENGTH(5u,       ZERO)
+RMGR_NSFR_CHECK_LENGTH(10u,      ZEROIEME)
+#undef RMGR_NSFR_CHECK_LENGTH
 
-static const char g_zero[]        = {"z\xC3\xA9ro"};
-static const char g_zeroieme[]    = {"z\xC3\xA9roi\xC3\xA8me"};
-static const char g_oneFeminine[] = {"une"};
 
-static const char g_space[] = {" "};
-static char const* const g_joiners[2] = {"-", " et "};
+//=================================================================================================
+// Sinks
 
-// Table of ordinals up to 16
-static char const* const g_ordinals[16] =
+/**
+ * @brief Sink that writes into a caller-provided buffer, without ever overflowing it
+ *
+ * Once the buffer is full, everything else is silently dropped and `overflow` is set.
+ */
+struct BufferSink
 {
-    "uni\xC3\xA8me",    "deuxi\xC3\xA8me",    "troisi\xC3\xA8me", "quatri\xC3\xA8me", //  1st  2nd  3rd  4th
-    "cinqui\xC3\xA8me", "sixi\xC3\xA8me",     "septi\xC3\xA8me",  "huiti\xC3\xA8me",  //  5th  6th  7th  8th
-    "neuvi\xC3\xA8me",  "dixi\xC3\xA8me",     "onzi\xC3\xA8me",   "douzi\xC3\xA8me",  //  9th 10th 11th 12th
-    "treizi\xC3\xA8me", "quatorzi\xC3\xA8me", "quinzi\xC3\xA8me", "seizi\xC3\xA8me"   // 13th 14th 15th 16th
+    char* cur;
+    char* last;
+    bool  overflow;
+
+    BufferSink(char* first, char* last_): cur(first), last(last_), overflow(false) {}
+
+    void append(const char* str, size_t length)
+    {
+        if (size_t(last - cur) < length)
+        {
+            overflow = true;
+            cur      = last;
+        }
+        else
+        {
+            memcpy(cur, str, length);
+            cur += length;
+        }
+    }
+
+    void append(const char* str) {append(str, strlen(str));}
+    void append(WordRef word)    {append(Words::pool + word.offset, word.length);}
+    void append(char c)          {append(&c, 1);}
 };
 
-static char const* const g_first[2]        = {"premier", "premi\xC3\xA8re"};
-static char const* const g_second[2]       = {"second",  "seconde"};
-static const char        g_ordinalEnding[] = {"i\xC3\xA8me"};
 
-// Table of cardinals for tens
-static char const* const g_cardinalTens[9] =
+/**
+ * @brief Sink that appends to an `std::string`
+ */
+struct StringSink
 {
-    "dix",      "vingt",    "trente",   "quarante", "cinquante", // 10 20 30 40 50
-    "soixante", "septante", "huitante", "nonante"                // 60 70 80 90
+    std::string& str;
+
+    explicit StringSink(std::string& str_): str(str_) {}
+
+    void append(const char* s, size_t length) {str.append(s, length);}
+    void append(const char* s)                {str.append(s);}
+    void append(WordRef word)                 {str.append(Words::pool + word.offset, word.length);}
+    void append(char c)                       {str += c;}
 };
 
-static const char g_quatreVingt[] = {"quatre-vingt"};
-static const char g_octante[]     = {"octante"};
 
-// Table of ordinals for tens
-static char const* const g_ordinalsTens[9] =
+//=================================================================================================
+// Group tables
+
+static const unsigned GROUP_OPTIONS_MASK = FEMININE | ORDINAL | SEPTANTE | OCTANTE | HUITANTE | NONANTE | PLURAL_ALLOWED;
+static const unsigned GROUP_TABLE_COUNT  = 128;
+
+/**
+ * @brief The precomputed spellings of all numbers within [1;999] for a given set of options
+ */
+struct GroupTable
 {
-    "dixi\xC3\xA8me",     "vingti\xC3\xA8me",    "trenti\xC3\xA8me",    // 10th 20th 30th
-    "quaranti\xC3\xA8me", "cinquanti\xC3\xA8me", "soixanti\xC3\xA8me",  // 40th 50th 60th
-    "septanti\xC3\xA8me", "huitanti\xC3\xA8me",  "nonanti\xC3\xA8me"    // 70th 80th 90th
+    std::atomic<bool> built;         ///< Allows to skip std::call_once() once built
+    std::vector<char> bytes;
+    uint16_t          offsets[1001]; ///< The spelling of `n` spans `[offsets[n]; offsets[n+1])` within `bytes`
 };
 
-static const char g_octanteOrdinal[] = {"octanti\xC3\xA8me"};
+static GroupTable     g_groupTables[GROUP_TABLE_COUNT];
+static std::once_flag g_groupTableFlags[GROUP_TABLE_COUNT];
 
 
-struct Numeral
+/**
+ * @brief Maps the options that matter below 1000 to an index within [0; GROUP_TABLE_COUNT)
+ */
+static unsigned group_table_index(unsigned options)
 {
-    uintmax_t   value;     ///< The value
-    const char* cardinal;
-};
+    return (options & (FEMININE | ORDINAL))                             // Bits 0-1
+         | ((options & (SEPTANTE | OCTANTE | HUITANTE | NONANTE)) >> 3) // Bits 2-5
+         | ((options & PLURAL_ALLOWED) ? 0x40u : 0u);                   // Bit  6
+}
+
 
-// Table of other numerals
-static const Numeral g_numerals[] =
+static void build_group_table(GroupTable& table, unsigned options)
 {
-    {       100, "cent"},
-    {      1000, "mille"},
-    {   1000000, "million"},
-    {1000000000, "milliard"},
+    CountingSink counter;
+    for (unsigned value = 1; value < 1000u; ++value)
+        recursive_format(counter, value, options);
+    table.bytes.resize(counter.length);
+    assert(counter.length <= UINT16_MAX);
 
-// 64-bit values
-#ifdef UINT64_C
-    {UINT64_C(      1000000000000), "billion"},  // 10^12
-    {UINT64_C(   1000000000000000), "billiard"}, // 10^15
-    {UINT64_C(1000000000000000000), "trillion"}, // 10^18
-#endif
+    BufferSink sink(table.bytes.data(), table.bytes.data() + table.bytes.size());
+    table.offsets[0] = 0;
+    table.offsets[1] = 0;
+    for (unsigned value = 1; value < 1000u; ++value)
+    {
+        recursive_format(sink, value, options);
+        table.offsets[value+1] = static_cast<uint16_t>(sink.cur - table.bytes.data());
+    }
+    assert(!sink.overflow);
 
-// 128-bit values
-#ifdef UINT128_C
-    {UINT128_C(               1000000000000000000000), "trilliard"},    // 10^21
-    {UINT128_C(            1000000000000000000000000), "quadrillion"},  // 10^24
-    {UINT128_C(         1000000000000000000000000000), "quadrilliard"}, // 10^27
-    {UINT128_C(      1000000000000000000000000000000), "quintillion"},  // 10^30
-    {UINT128_C(   1000000000000000000000000000000000), "quintilliard"}, // 10^33
-    {UINT128_C(1000000000000000000000000000000000000), "sextillion"},   // 10^36
-    {UINT128_C(1000000000000000000000000000000000000), "sextilliard"},  // 10^39
-#endif
-};
+    table.built.store(true, std::memory_order_release);
+}
+
+
+/**
+ * @brief Retrieves the spellings of all numbers within [1;999] for @p options, building them if needed
+ */
+static const GroupTable& group_table(unsigned options)
+{
+    const unsigned index = group_table_index(options);
+    GroupTable&    table = g_groupTables[index];
+    if (!table.built.load(std::memory_order_acquire))
+        std::call_once(g_groupTableFlags[index], build_group_table, std::ref(table), (options & GROUP_OPTIONS_MASK));
+    return table;
+}
 
-static const char g_millieme[] = {"milli\xC3\xA8me"};
 
+/**
+ * @brief Appends the spelling of a number within [1;999], as precomputed in @p table
+ */
+template<typename Sink>
+static void append_group(Sink& sink, const GroupTable& table, unsigned value)
+{
+    assert(1<=value && value<=999);
+
+    const uint16_t begin = table.offsets[value];
+    sink.append(table.bytes.data() + begin, table.offsets[value+1] - begin);
+}
 
-static const unsigned TYPE_MASK      = CARDINAL | ORDINAL | CARDINAL_AS_ORDINAL | ORDINAL_SUFFIX;
-static const unsigned PLURAL_ALLOWED = 0x1000;
 
 //=================================================================================================
-// Formatting
+// Profiles
+
+static const unsigned PROFILE_OPTIONS_MASK = FEMININE | TYPE_MASK | SECOND | SEPTANTE | OCTANTE | HUITANTE | NONANTE | CENT_1100_1999;
+static const unsigned PROFILE_COUNT        = PROFILE_OPTIONS_MASK + 1;
+static const unsigned PROFILE_KIND_MASK    = ORDINAL | CENT_1100_1999 | PLURAL_ALLOWED; // The only options iterative_format() tests
 
 /**
- * @brief Retrieves the names for values within [1;16]
+ * @brief A set of options, resolved once and for all
  */
-static const char* format_below17(unsigned value, unsigned options)
+struct internal::Profile
 {
-    assert(1<=value && value<=16);
-    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+    std::atomic<bool> built;                ///< Allows to skip std::call_once() once built
+    unsigned          options;              ///< The options, as given by the user
+    const GroupTable* groups;               ///< The spellings of the lowest group
+    const GroupTable* nounMultipliers;      ///< The spellings of the multipliers of million, milliard, ...
+    const GroupTable* adjectiveMultipliers; ///< The spellings of the multipliers of mille, cent and ordinal nouns
+};
 
-    if (options & ORDINAL)
-        return g_ordinals[value-1];
-    else if (value==1u && (options & FEMININE))
-        return g_oneFeminine;
-    else
-        return g_cardinals[value-1];
+static internal::Profile g_profiles[PROFILE_COUNT];
+static std::once_flag    g_profileFlags[PROFILE_COUNT];
+
+
+static void build_profile(internal::Profile& profile, unsigned options)
+{
+    profile.options = options;
+
+    // The suffix alone doesn't need any table
+    if (!(options & ORDINAL_SUFFIX))
+    {
+        const unsigned numberOptions = internal::number_options(options);
+        const unsigned nounOptions   = numberOptions & ~(TYPE_MASK | FEMININE); // Masculine cardinal
+        profile.groups               = &group_table(numberOptions);
+        profile.nounMultipliers      = &group_table(nounOptions);
+        profile.adjectiveMultipliers = &group_table(nounOptions & ~PLURAL_ALLOWED);
+    }
+
+    profile.built.store(true, std::memory_order_release);
+}
+
+
+const internal::Profile* internal::resolve_profile(unsigned options)
+{
+    options &= PROFILE_OPTIONS_MASK;
+    Profile& profile = g_profiles[options];
+    if (!profile.built.load(std::memory_order_acquire))
+        std::call_once(g_profileFlags[options], build_profile, std::ref(profile), options);
+    return &profile;
+}
+
+
+unsigned internal::profile_options(const Profile& profile)
+{
+    return profile.options;
+}
+
+
+/**
+ * @brief Normalizes options, so that options spelled out the same way are equal
+ *
+ * Bits that the profiles ignore are dropped, and "huitante" overrides "octante".
+ */
+static unsigned normalized_options(unsigned options)
+{
+    options &= PROFILE_OPTIONS_MASK;
+    if ((options & (HUITANTE | OCTANTE)) == (HUITANTE | OCTANTE))
+        options &= ~OCTANTE;
+    return options;
 }
 
 
+//=================================================================================================
+// Engines
+
 /**
- * @brief Retrieves the names for tens units
+ * @brief Engine that looks every group up from the tables resolved by a profile
  */
-static const char* format_tens(unsigned tens, unsigned options)
+struct ProfileEngine
 {
-    assert(1<=tens && tens<=9);
-    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+    const internal::Profile& profile;
 
-    if (options & ORDINAL)
+    explicit ProfileEngine(const internal::Profile& profile_): profile(profile_) {}
+
+    template<typename Sink> void begin_group(Sink&, size_t)                                        const {}
+    template<typename Sink> void append_group(Sink& sink, unsigned value, unsigned)                const {nsfr::append_group(sink, *profile.groups, value);}
+    template<typename Sink> void append_noun_multiplier(Sink& sink, unsigned value, unsigned)      const {nsfr::append_group(sink, *profile.nounMultipliers, value);}
+    template<typename Sink> void append_adjective_multiplier(Sink& sink, unsigned value, unsigned) const {nsfr::append_group(sink, *profile.adjectiveMultipliers, value);}
+
+    template<typename Sink, typename Uint>
+    void format_number(Sink& sink, Uint value, unsigned options) const
+    {
+        // Dispatch to a specialization of iterative_format() for the options it tests
+        switch (options & PROFILE_KIND_MASK)
+        {
+            case ORDINAL:                                   format_kind<ORDINAL>                          (sink, value, options); break;
+            case ORDINAL | CENT_1100_1999:                  format_kind<ORDINAL | CENT_1100_1999>         (sink, value, options); break;
+            case CARDINAL:                                  format_kind<CARDINAL>                         (sink, value, options); break;
+            case CARDINAL | CENT_1100_1999:                 format_kind<CARDINAL | CENT_1100_1999>        (sink, value, options); break;
+            case PLURAL_ALLOWED:                            format_kind<PLURAL_ALLOWED>                   (sink, value, options); break;
+            case PLURAL_ALLOWED | CENT_1100_1999:           format_kind<PLURAL_ALLOWED | CENT_1100_1999>  (sink, value, options); break;
+            default: assert(false);
+        }
+    }
+
+    template<unsigned Kind, typename Sink, typename Uint>
+    void format_kind(Sink& sink, Uint value, unsigned options) const
     {
-        if (tens==8u && (options & OCTANTE))
-            return g_octanteOrdinal;
-        return g_ordinalsTens[tens-1];
+        // Pinning these bits down lets the compiler fold away the branches that depend on them
+        iterative_format(sink, value, (options & ~PROFILE_KIND_MASK) | Kind, *this);
     }
-    else
+};
+
+
+/**
+ * @brief Engine that is the straight application of the rules, without any precomputed table
+ */
+struct ReferenceEngine
+{
+    template<typename Sink, typename Uint>
+    void format_number(Sink& sink, Uint value, unsigned options) const
     {
-        if (tens==8u && (options & OCTANTE))
-            return g_octante;
-        return g_cardinalTens[tens-1];
+        recursive_format(sink, value, options);
     }
+};
+
+
+template<typename Integer>
+static to_words_result to_words_impl(const internal::Profile& profile, char* first, char* last, Integer value)
+{
+    BufferSink sink(first, last);
+    format(sink, value, profile.options, ProfileEngine(profile));
+    if (sink.overflow)
+        return to_words_result{last, std::errc::value_too_large};
+    return to_words_result{sink.cur, std::errc()};
+}
+
+
+template<typename Integer>
+static std::string spell_out_impl(const internal::Profile& profile, Integer value)
+{
+    // All spellings fit in there, allowing to allocate the string only once
+    char buffer[internal::max_size(max_spelled_length<Integer>(ORDINAL | FEMININE), max_spelled_length<Integer>(CARDINAL | FEMININE))];
+    const to_words_result result = to_words_impl(profile, buffer, buffer + sizeof(buffer), value);
+    assert(result.ec == std::errc());
+    return std::string(buffer, result.ptr);
+}
+
+
+template<typename Integer>
+static std::string spell_out_reference_impl(Integer value, unsigned options)
+{
+    std::string str;
+    StringSink  sink(str);
+    format(sink, value, options, ReferenceEngine());
+    return str;
+}
+
+
+template<typename Integer>
+static void append_to_impl(const internal::Profile& profile, std::string& str, Integer value)
+{
+    StringSink sink(str);
+    format(sink, value, profile.options, ProfileEngine(profile));
+}
+
+
+template<typename Integer>
+static size_t spelled_length_impl(const internal::Profile& profile, Integer value)
+{
+    CountingSink sink;
+    format(sink, value, profile.options, ProfileEngine(profile));
+    return sink.length;
+}
+
+
+//=================================================================================================
+// Parsing
+
+enum WordKind
+{
+    WORD_ZERO,     ///< "zéro", only on its own
+    WORD_FIRST,    ///< "premier", "second" and their feminine forms, only on their own
+    WORD_UNIT,     ///< 1 - 16
+    WORD_TENS,     ///< 20 - 90
+    WORD_HUNDRED,  ///< "cent"
+    WORD_SCALE,    ///< "mille", "million", "milliard", ...
+    WORD_ET,       ///< "et", which is only allowed before 1 and 11
+    WORD_MINUS     ///< "moins"
+};
+
+/**
+ * @brief A word numbers are made of, along with its meaning
+ */
+struct Word
+{
+    uint16_t  offset;  ///< Position of the word within WordTable::text
+    uint8_t   length;
+    uint8_t   kind;    ///< A WordKind
+    unsigned  options; ///< The options this word implies (ORDINAL, FEMININE, SEPTANTE, ...)
+    uintmax_t value;
+};
+
+static const unsigned WORD_SLOT_BITS  = 10;
+static const unsigned WORD_SLOT_COUNT = 1u << WORD_SLOT_BITS;
+static const unsigned MAX_WORD_COUNT  = 255;
+
+/**
+ * @brief Perfect hash table of all the words numbers are made of
+ *
+ * The words are those of the very tables used to spell numbers out, so both cannot drift apart.
+ */
+struct WordTable
+{
+    std::atomic<bool> built;                  ///< Allows to skip std::call_once() once built
+    uint32_t          seed;                   ///< Seed of the hash function, chosen so that there is no collision
+    size_t            maxLength;              ///< The length of the longest word
+    size_t            wordCount;
+    Word              words[MAX_WORD_COUNT];
+    char              text[2048];             ///< All the words, back-to-back
+    size_t            textLength;
+    uint8_t           slots[WORD_SLOT_COUNT]; ///< 1 + index within `words`, 0 if empty
+};
+
+static WordTable      g_wordTable;
+static std::once_flag g_wordTableFlag;
+
+
+static uint32_t hash_word(const char* word, size_t length, uint32_t seed)
+{
+    // FNV-1a, keeping the most significant bits
+    uint32_t hash = seed;
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ static_cast<unsigned char>(word[i])) * 16777619u;
+    return hash >> (32 - WORD_SLOT_BITS);
 }
 
 
-static void recursive_format(std::string& result, uintmax_t value, unsigned options);
+static const WordRef g_noSuffix = {0, 0, 0};
 
 
 /**
- * @brief Special handling of numbers between 70 and 99 for reference French
+ * @brief Adds a word to the table, @p suffix being appended to @p word
  */
-void format70_99(std::string& result, unsigned value, unsigned options)
+static void add_word(WordTable& table, const char* word, size_t length, WordRef suffix, WordKind kind, uintmax_t value, unsigned options)
+{
+    const size_t suffixLength = suffix.length;
+    assert(table.wordCount < MAX_WORD_COUNT);
+    assert(table.textLength + length + suffixLength <= sizeof(table.text));
+
+    Word& entry   = table.words[table.wordCount++];
+    entry.offset  = static_cast<uint16_t>(table.textLength);
+    entry.length  = static_cast<uint8_t>(length + suffixLength);
+    entry.kind    = static_cast<uint8_t>(kind);
+    entry.options = options;
+    entry.value   = value;
+    memcpy(table.text + table.textLength, word, length);
+    memcpy(table.text + table.textLength + length, Words::pool + suffix.offset, suffixLength);
+    table.textLength += entry.length;
+    if (entry.length > table.maxLength)
+        table.maxLength = entry.length;
+}
+
+
+static void add_word(WordTable& table, WordRef word, WordRef suffix, WordKind kind, uintmax_t value, unsigned options)
+{
+    add_word(table, Words::pool + word.offset, word.length, suffix, kind, value, options);
+}
+
+
+static void build_word_table(WordTable& table)
 {
-    assert(70<=value && value<=99);
-    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+    // The variant each of the tens implies
+    static const unsigned tensOptions[9] = {0, 0, 0, 0, 0, 0, SEPTANTE, HUITANTE, NONANTE};
 
-    if (value <= 79)              // 70-79 with a special case at 71
+    add_word(table, internal::g_zero,     g_noSuffix, WORD_ZERO,  0, CARDINAL);
+    add_word(table, internal::g_zeroieme, g_noSuffix, WORD_ZERO,  0, ORDINAL);
+    for (unsigned gender = MASCULINE; gender <= FEMININE; ++gender)
+    {
+        add_word(table, Words::first[gender],  g_noSuffix, WORD_FIRST, 1, ORDINAL | gender);
+        add_word(table, Words::second[gender], g_noSuffix, WORD_FIRST, 2, ORDINAL | SECOND | gender);
+    }
+    add_word(table, internal::g_oneFeminine, g_noSuffix, WORD_UNIT, 1, FEMININE);
+    for (unsigned value = 1; value <= 16u; ++value)
     {
-        result += g_cardinalTens[5];       // Based on "soixante"
-        result += g_joiners[value == 71u]; // 71 doesn't take an hyphen but "et" instead
-        recursive_format(result, value-60, (options & ~PLURAL_ALLOWED));
+        add_word(table, Words::cardinals[value-1], g_noSuffix, WORD_UNIT, value, CARDINAL);
+        add_word(table, Words::ordinals[value-1],  g_noSuffix, WORD_UNIT, value, ORDINAL);
     }
-    else                         // 80-99
+    for (unsigned tens = 2; tens <= 9u; ++tens)
     {
-        result += g_quatreVingt;
-        if (value == 80u)
+        add_word(table, Words::cardinalTens[tens-1], g_noSuffix, WORD_TENS, tens * 10u, tensOptions[tens-1]);
+        add_word(table, Words::ordinalsTens[tens-1], g_noSuffix, WORD_TENS, tens * 10u, tensOptions[tens-1] | ORDINAL);
+    }
+    add_word(table, Words::cardinalTens[1],     internal::g_plural, WORD_TENS, 20, CARDINAL); // "quatre-vingts"
+    add_word(table, internal::g_octante,        g_noSuffix,         WORD_TENS, 80, OCTANTE);
+    add_word(table, internal::g_octanteOrdinal, g_noSuffix,         WORD_TENS, 80, OCTANTE | ORDINAL);
+
+    const size_t numeralCount = sizeof(Words::numerals) / sizeof(Words::numerals[0]);
+    for (size_t i = 0; i < numeralCount; ++i)
+    {
+        const Words::Numeral& numeral = Words::numerals[i];
+        const WordKind  kind  = (numeral.value == 100u) ? WORD_HUNDRED : WORD_SCALE;
+        const uintmax_t value = (numeral.value <= UINTMAX_MAX) ? uintmax_t(numeral.value) : UINTMAX_MAX; // Out of range anyway
+        add_word(table, numeral.cardinal, g_noSuffix,                kind, value, CARDINAL);
+        if (value != 1000u)
         {
-            if (options & ORDINAL)              // Add the ordinal ending
-                result += g_ordinalEnding;
-            else if (options & PLURAL_ALLOWED)  // When allowed to, append the 's' for plural
-                result += 's';
+            add_word(table, numeral.cardinal, internal::g_plural,        kind, value, CARDINAL);
+            add_word(table, numeral.cardinal, internal::g_ordinalEnding, kind, value, ORDINAL);
         }
-        else
+    }
+    add_word(table, internal::g_millieme, g_noSuffix, WORD_SCALE, 1000, ORDINAL);
+
+    add_word(table, Words::pool + Words::joiners[1].offset + 1, Words::joiners[1].length - 2u, g_noSuffix, WORD_ET, 0, 0); // " et "
+    add_word(table, internal::g_minus, g_noSuffix, WORD_MINUS, 0, 0);
+
+    // Look for a seed without any collision, which takes a few hundred attempts
+    for (table.seed = 2166136261u; ; ++table.seed)
+    {
+        memset(table.slots, 0, sizeof(table.slots));
+        size_t i = 0;
+        while (i < table.wordCount)
         {
-            result += g_joiners[0];
-            recursive_format(result, value-80, (options & ~PLURAL_ALLOWED));
+            const Word& word = table.words[i];
+            uint8_t&    slot = table.slots[hash_word(table.text + word.offset, word.length, table.seed)];
+            if (slot != 0u)
+                break;
+            slot = static_cast<uint8_t>(i + 1);
+            ++i;
         }
+        if (i == table.wordCount)
+            break;
     }
+
+    table.built.store(true, std::memory_order_release);
+}
+
+
+static const WordTable& word_table()
+{
+    if (!g_wordTable.built.load(std::memory_order_acquire))
+        std::call_once(g_wordTableFlag, build_word_table, std::ref(g_wordTable));
+    return g_wordTable;
 }
 
 
 /**
- * @brief Recursive formatting function
+ * @brief Looks a word up, with a single string comparison
  *
- * @param aNumber        The number to format
- * @param aType          Format as a cardinal or an ordinal?
- * @param aGender        The gender the number is related to (masculine or feminine)
- * @param aPluralAllowed Is the plural form authorised? It is not when dealing with ordinals.
- * @param aResult        Where to store the resulting formatted text
+ * @return The word, `nullptr` if it is unknown
+ */
+static const Word* find_word(const WordTable& table, const char* word, size_t length)
+{
+    if (length == 0u || length > table.maxLength)
+        return nullptr;
+    const uint8_t slot = table.slots[hash_word(word, length, table.seed)];
+    if (slot == 0u)
+        return nullptr;
+    const Word& entry = table.words[slot - 1];
+    if (entry.length != length || memcmp(table.text + entry.offset, word, length) != 0)
+        return nullptr;
+    return &entry;
+}
+
+
+/**
+ * @brief State machine that accumulates the words of a number, from left to right
  */
-static void recursive_format(std::string& result, uintmax_t value, unsigned options)
+struct NumberParser
 {
-    assert(((options & TYPE_MASK) == CARDINAL) || ((options & TYPE_MASK) == ORDINAL));
+    uintmax_t total;     ///< The sum of the groups already multiplied by their scale
+    uintmax_t scale;     ///< The scale of the last group, the next ones must be smaller (0 if none)
+    unsigned  hundreds;  ///< The hundreds of the current group
+    unsigned  below100;  ///< The rest of the current group
+    unsigned  options;
+    bool      negative;
+    bool      afterEt;
+    bool      hasNumber; ///< Whether at least one word of the number itself has been read
+    bool      complete;  ///< Whether nothing may follow (ordinals, "zéro", "premier", ...)
+    bool      overflow;
+
+    NumberParser(): total(0), scale(0), hundreds(0), below100(0), options(0),
+                    negative(false), afterEt(false), hasNumber(false), complete(false), overflow(false) {}
 
-    if (value < 17u)                                     // 1 - 16
-        result += format_below17(static_cast<unsigned>(value), options);
-    else if (value < 100u)                               // 17 - 99
+    uintmax_t value() const {return total + hundreds + below100;}
+
+    /**
+     * @brief Adds a word to the number
+     *
+     * @return Whether the word can be part of the number, if not it's the end of the number
+     */
+    bool add(const Word& word)
     {
-        if (   (value <= 69u)
-            || (value <= 79u && (options & SEPTANTE))
-            || (value <= 89u && (options & (HUITANTE | OCTANTE)))
-            || (options & NONANTE))
+        if (complete)
+            return false;
+
+        switch (word.kind)
         {
-            const unsigned tens = static_cast<unsigned>(value / 10u);
-            const unsigned ones = static_cast<unsigned>(value % 10u);
-            if (ones == 0u)
-                result += format_tens(tens, options);
-            else
+            case WORD_MINUS:
+                if (negative || hasNumber)
+                    return false;
+                negative = true;
+                return true;
+
+            case WORD_ET:
+                // "et" may only be found between tens and 1 or 11 ("vingt et un", "soixante et onze")
+                if (afterEt || below100 < 20u || below100 % 10u != 0u)
+                    return false;
+                afterEt = true;
+                return true;
+
+            case WORD_ZERO:
+            case WORD_FIRST:
+                if (hasNumber)
+                    return false;
+                below100 = static_cast<unsigned>(word.value);
+                complete = true;
+                break;
+
+            case WORD_UNIT:
             {
-                result += format_tens(tens, ((options & ~TYPE_MASK) | CARDINAL));
-                result += g_joiners[ones == 1u];
-                result += format_below17(ones, options);
+                const unsigned unit = static_cast<unsigned>(word.value);
+                if (afterEt && unit != 1u && unit != 11u)
+                    return false;
+                // Units may follow tens ("vingt-deux", "dix-sept"), but only 60 & 80 may be followed by 10-16
+                if (below100 != 0u && !(below100 % 10u == 0u && (unit <= 9u || below100 == 60u || below100 == 80u)))
+                    return false;
+                below100 += unit;
+                break;
             }
-        }
-        else                                             // 70 - 99 for reference French
-            format70_99(result, static_cast<unsigned>(value), options);
-    }
-    else                                                 // 100 - ...
-    {
-        const Numeral* numeral;
-        // Force the use of "cent" for [1100; 1999]
-        if ((options & CENT_1100_1999) && 1100<=value && value<=1999)
-            numeral = &g_numerals[0];
-        // Regular case: find the appropriate numeral
-        else
-        {
-            const size_t numeralCount = sizeof(g_numerals) / sizeof(g_numerals[0]);
-            size_t i = 0;
-            while (i < numeralCount && g_numerals[i].value <= value)
-                ++i;
-            numeral = &g_numerals[i-1];
-        }
 
-        // Compute the multiplier & remainder
-        const uintmax_t multiplier = value / numeral->value;
-        const uintmax_t remainder  = value % numeral->value;
+            case WORD_TENS:
+                if (afterEt)
+                    return false;
+                if (below100 == 4u && word.value == 20u) // "quatre-vingt"
+                    below100 = 80;
+                else if (below100 == 0u)
+                    below100 = static_cast<unsigned>(word.value);
+                else
+                    return false;
+                break;
 
-        // Check the numeral's properties
-        const bool isNoun    = (numeral->value > 1000u && !((options & ORDINAL) && remainder==0u));
-        const bool hasPlural = (numeral->value != 1000u);
+            case WORD_HUNDRED:
+                if (afterEt || hundreds != 0u || below100 >= 20u)
+                    return false;
+                if (below100 >= 10u)
+                    options |= CENT_1100_1999;
+                hundreds = ((below100 != 0u) ? below100 : 1u) * 100u;
+                below100 = 0;
+                break;
 
-        // Add the multiplier (if needed)
-        if (multiplier>1u || isNoun)
-        {
-            unsigned newOptions = options & ~(TYPE_MASK | FEMININE); // Force masculine cardinal
-            if (!isNoun)
-                newOptions &= ~PLURAL_ALLOWED;
-            recursive_format(result, multiplier, newOptions);
-            result += g_space;
-        }
-
-        // The numeral itself (with the plural form if needed)
-        if ((options & ORDINAL) && !remainder)
-        {
-            if (numeral->value == 1000u)
-                result += g_millieme;
-            else
+            case WORD_SCALE:
             {
-                result += numeral->cardinal;
-                result += g_ordinalEnding;
+                if (afterEt || (scale != 0u && word.value >= scale))
+                    return false;
+                const unsigned multiplier = (hundreds + below100 != 0u) ? (hundreds + below100) : 1u;
+                if (multiplier >= 1000u)
+                    return false;
+                if (word.value == UINTMAX_MAX || multiplier > UINTMAX_MAX / word.value || total > UINTMAX_MAX - multiplier * word.value)
+                    overflow = true;
+                total   += multiplier * word.value;
+                scale    = word.value;
+                hundreds = 0;
+                below100 = 0;
+                break;
             }
         }
-        else
-        {
-            result += numeral->cardinal;
-            if (multiplier>1u && (isNoun || ((options & PLURAL_ALLOWED) && hasPlural && !remainder)))
-                result += 's';
-        }
 
-        // The remainder if any
-        if (remainder)
-        {
-            result += g_space;
-            recursive_format(result, remainder, options);
-        }
+        // The current group is only added by value(), but it may not fit either (e.g. "dix-huit trillions [...] six cent seize")
+        if (total > UINTMAX_MAX - (hundreds + below100))
+            overflow = true;
+
+        options  |= word.options;
+        afterEt   = false;
+        hasNumber = true;
+        if (word.options & ORDINAL)
+            complete = true;
+        return true;
     }
-}
+};
+
 
+//=================================================================================================
+// Decimal strings
 
-static void format(std::string& result, uintmax_t value, unsigned options)
+/**
+ * @brief A Latin prefix of the Conway-Wechsler system, along with the markers it imposes on the units
+ */
+struct LatinPrefix
 {
-    if (options & ORDINAL_SUFFIX)
-    {
-        if (value == 1u)
-            result = (options & FEMININE) ? "re" : "er";
-        else if (value==2u && (options & SECOND))
-            result = (options & FEMININE) ? "de" : "d";
-        else
-            result = 'e';
-    }
+    const char* word;
+    const char* markers; ///< Turn "tre" into "tres" (s, x), "se" into "ses" (s) or "sex" (x), "septe" & "nove" into "septem" & "novem" (m) or "septen" & "noven" (n)
+};
+
+static const char* const g_latinSmall[10] = {"ni", "mi", "bi", "tri", "quadri", "quinti", "sexti", "septi", "octi", "noni"};
+static const char* const g_latinUnits[10] = {"", "un", "duo", "tre", "quattuor", "quinqua", "se", "septe", "octo", "nove"};
+
+static const LatinPrefix g_latinTens[10] =
+{
+    {"",             ""  },
+    {"d\xC3\xA9" "ci", "n" },
+    {"viginti",      "ms"},
+    {"triginta",     "ns"},
+    {"quadraginta",  "ns"},
+    {"quinquaginta", "ns"},
+    {"sexaginta",    "n" },
+    {"septuaginta",  "n" },
+    {"octoginta",    "mx"},
+    {"nonaginta",    ""  },
+};
+
+static const LatinPrefix g_latinHundreds[10] =
+{
+    {"",             ""  },
+    {"centi",        "nx"},
+    {"ducenti",      "n" },
+    {"trecenti",     "ns"},
+    {"quadringenti", "ns"},
+    {"quingenti",    "ns"},
+    {"sescenti",     "n" },
+    {"septingenti",  "n" },
+    {"octingenti",   "mx"},
+    {"nongenti",     ""  },
+};
+
+
+/**
+ * @brief Appends the Latin prefix of @p value (within [0;999]) followed by "illi"
+ */
+template<typename Sink>
+static void append_latin_prefix(Sink& sink, unsigned value)
+{
+    const unsigned units    = value % 10u;
+    const unsigned tens     = (value / 10u) % 10u;
+    const unsigned hundreds = value / 100u;
+
+    // The final vowel is dropped in front of "illi", and all prefixes end with one
+    const char* lastWord;
+    if (value < 10u)
+        lastWord = g_latinSmall[value];
     else
     {
-        // "huitante" overrides "octante"
-        if (options & HUITANTE)
-            options &= ~OCTANTE;
-
-        if (value == 0u)
-            result += (options & ORDINAL) ? g_zeroieme : g_zero;
-        else if (value==1u && (options & ORDINAL))
-            result += g_first[options & FEMININE];
-        else if (value==2u && ((options & (ORDINAL | SECOND)) == (ORDINAL | SECOND)))
-            result += g_second[options & FEMININE];
-        else
+        if (units != 0u)
         {
-            unsigned newOptions = options;
-            if ((options & TYPE_MASK) == CARDINAL)
-                newOptions |= PLURAL_ALLOWED;
-            else if (options & CARDINAL_AS_ORDINAL)
-                newOptions = (newOptions & ~TYPE_MASK) | CARDINAL;
-            recursive_format(result, value, newOptions);
+            sink.append(g_latinUnits[units]);
+            const char* markers = (tens != 0u) ? g_latinTens[tens].markers : g_latinHundreds[hundreds].markers;
+            if (units==3u && (strchr(markers, 's') || strchr(markers, 'x')))
+                sink.append('s');
+            else if (units==6u && strchr(markers, 's'))
+                sink.append('s');
+            else if (units==6u && strchr(markers, 'x'))
+                sink.append('x');
+            else if ((units==7u || units==9u) && strchr(markers, 'm'))
+                sink.append('m');
+            else if ((units==7u || units==9u) && strchr(markers, 'n'))
+                sink.append('n');
         }
+        if (tens != 0u && hundreds != 0u)
+            sink.append(g_latinTens[tens].word);
+        lastWord = (hundreds != 0u) ? g_latinHundreds[hundreds].word : g_latinTens[tens].word;
     }
+    sink.append(lastWord, strlen(lastWord) - 1);
+    sink.append("illi", 4);
 }
 
 
-static void format(std::string& result, intmax_t value, unsigned options)
+/**
+ * @brief Appends the name of 10^(6n) ("illion") or 10^(6n+3) ("illiard") in the long scale
+ *
+ * The names are those of the Conway-Wechsler system: million, billion, ..., décillion, undécillion,
+ * ..., vigintillion, ..., centillion, ..., millinillion (n = 1000), ...
+ */
+template<typename Sink>
+static void append_long_scale_name(Sink& sink, size_t n, bool illiard)
 {
-    assert(!(value<0 && (options & (ORDINAL | ORDINAL_SUFFIX))));
+    assert(n != 0u);
 
-    if (value < 0)
+    // Beyond 999, the prefixes of each base-1000 digit of n are chained
+    unsigned digits[(sizeof(size_t) * CHAR_BIT + 9) / 10 + 1];
+    unsigned count = 0;
+    do
     {
-        result += "moins ";
-        value = -value;
+        digits[count++] = static_cast<unsigned>(n % 1000u);
+        n /= 1000u;
     }
+    while (n != 0u);
 
-    format(result, static_cast<uintmax_t>(value), options);
+    while (count != 0u)
+        append_latin_prefix(sink, digits[--count]);
+    sink.append(illiard ? "ard" : "on");
 }
 
 
-//=================================================================================================
-// API
-
-std::string internal::spell_out(intmax_t value, unsigned options)
+/**
+ * @brief The base-1000 groups of a number given as a string of decimal digits
+ *
+ * Groups are read from the digits on demand, so no memory is needed whatever the length.
+ */
+struct DecimalGroups
 {
-    std::string result;
-    format(result, value, options);
-    return result;
-}
+    const char* digits; ///< Without leading zeros
+    size_t      length;
 
+    DecimalGroups(const char* digits_, size_t length_): digits(digits_), length(length_) {}
 
-std::string internal::spell_out(uintmax_t value, unsigned options)
+    size_t size() const {return (length + 2u) / 3u;}
+
+    unsigned operator[](size_t i) const
+    {
+        const size_t end   = length - 3u * i;
+        size_t       begin = (end > 3u) ? end - 3u : 0u;
+        unsigned value = 0;
+        for (; begin != end; ++begin)
+            value = value * 10u + unsigned(digits[begin] - '0');
+        return value;
+    }
+
+    template<typename Sink>
+    void append_scale(Sink& sink, size_t i) const
+    {
+        assert(i >= 2u);
+        append_long_scale_name(sink, i / 2u, (i % 2u) != 0u);
+    }
+};
+
+
+/**
+ * @brief Sink that hands the output over to a callback, in chunks
+ */
+struct WriterSink
 {
-    std::string result;
-    format(result, value, options);
-    return result;
+    write_function write;
+    void*          context;
+    size_t         size;
+    char           buffer[256];
+
+    WriterSink(write_function write_, void* context_): write(write_), context(context_), size(0) {}
+    ~WriterSink() {flush();}
+
+    void append(const char* str, size_t length)
+    {
+        if (length > sizeof(buffer) - size)
+        {
+            flush();
+            if (length > sizeof(buffer))
+            {
+                write(context, str, length);
+                return;
+            }
+        }
+        memcpy(buffer + size, str, length);
+        size += length;
+    }
+
+    void append(const char* str) {append(str, strlen(str));}
+    void append(WordRef word)    {append(Words::pool + word.offset, word.length);}
+    void append(char c)          {append(&c, 1);}
+
+    void flush()
+    {
+        if (size != 0u)
+            write(context, buffer, size);
+        size = 0;
+    }
+};
+
+
+/**
+ * @brief Spells out a string of decimal digits, possibly with leading zeros
+ */
+template<typename Sink>
+static void format_digits(Sink& sink, const char* first, const char* last, unsigned options)
+{
+    assert(first != last);
+    while (first != last-1 && *first == '0')
+        ++first;
+
+    const internal::Profile& profile = *internal::resolve_profile(options);
+    const size_t length = size_t(last - first);
+    if (length <= size_t(std::numeric_limits<uintmax_t>::digits10))
+    {
+        // Small enough for the special cases, and for native arithmetic
+        uintmax_t value = 0;
+        for (const char* cur = first; cur != last; ++cur)
+            value = value * 10u + unsigned(*cur - '0');
+        format(sink, value, profile.options, ProfileEngine(profile));
+    }
+    else if (options & ORDINAL_SUFFIX)
+        sink.append(internal::g_suffix);
+    else
+        internal::format_groups(sink, DecimalGroups(first, length), internal::number_options(profile.options), ProfileEngine(profile));
+}
+
+
+static bool is_zero(const char* first, const char* last)
+{
+    for (; first != last; ++first)
+        if (*first != '0')
+            return false;
+    return true;
+}
+
+
+/**
+ * @brief Spells out a string of decimal digits, possibly negative
+ *
+ * The string is validated beforehand, so that nothing is output if it is invalid.
+ */
+template<typename Sink>
+static std::errc format_decimal(Sink& sink, const char* first, const char* last, unsigned options)
+{
+    const bool negative = (first != last && *first == '-');
+    if (negative)
+    {
+        if (options & (ORDINAL | ORDINAL_SUFFIX))
+            return std::errc::invalid_argument;
+        ++first;
+    }
+    if (first == last)
+        return std::errc::invalid_argument;
+    for (const char* cur = first; cur != last; ++cur)
+        if (*cur < '0' || *cur > '9')
+            return std::errc::invalid_argument;
+
+    if (negative && !is_zero(first, last))
+    {
+        sink.append(internal::g_minus);
+        sink.append(internal::g_space);
+    }
+    format_digits(sink, first, last, options);
+    return std::errc();
+}
+
+
+//=================================================================================================
+// Fixed-point and floating-point numbers
+
+static const char g_zeroDigit[] = "0";
+
+
+/**
+ * @brief Spells out a number with a fractional part: the integer part, the decimal word, then the fractional part
+ *
+ * The fractional part is made of @p fractionZeros zeros followed by `[fractionFirst; fractionLast)`.
+ * Its leading zeros are spelled one by one ("zéro zéro cinq"), the remaining digits as a number
+ * (trailing zeros included, so 1.50 as a fixed-point number is "un virgule cinquante"). It is
+ * omitted when it is zero.
+ */
+template<typename Sink>
+static std::errc format_fixed(Sink& sink, bool negative, const char* integerFirst, const char* integerLast,
+                              size_t fractionZeros, const char* fractionFirst, const char* fractionLast,
+                              unsigned options, const char* decimalWord)
+{
+    if (options & (ORDINAL | ORDINAL_SUFFIX))
+        return std::errc::invalid_argument;
+
+    const bool hasFraction = !is_zero(fractionFirst, fractionLast);
+    if (negative && (hasFraction || !is_zero(integerFirst, integerLast)))
+    {
+        sink.append(internal::g_minus);
+        sink.append(internal::g_space);
+    }
+    format_digits(sink, integerFirst, integerLast, options);
+    if (!hasFraction)
+        return std::errc();
+
+    sink.append(internal::g_space);
+    sink.append(decimalWord);
+    for (; *fractionFirst == '0'; ++fractionFirst)
+        ++fractionZeros;
+    for (; fractionZeros != 0u; --fractionZeros)
+    {
+        sink.append(internal::g_space);
+        sink.append(internal::g_zero);
+    }
+    sink.append(internal::g_space);
+    format_digits(sink, fractionFirst, fractionLast, options);
+    return std::errc();
+}
+
+
+/**
+ * @brief Spells out the fixed-point number @p mantissa * 10^-scale
+ */
+template<typename Sink>
+static std::errc format_fixed(Sink& sink, intmax_t mantissa, unsigned scale, unsigned options, const char* decimalWord)
+{
+    // Negating in the unsigned domain, as -INTMAX_MIN overflows
+    uintmax_t magnitude = static_cast<uintmax_t>(mantissa);
+    if (mantissa < 0)
+        magnitude = 0u - magnitude;
+
+    char        digits[std::numeric_limits<uintmax_t>::digits10 + 1];
+    char* const last  = digits + sizeof(digits);
+    char*       first = last;
+    do
+    {
+        *--first   = char('0' + unsigned(magnitude % 10u));
+        magnitude /= 10u;
+    }
+    while (magnitude != 0u);
+
+    const size_t count = size_t(last - first);
+    if (scale >= count)
+        return format_fixed(sink, mantissa < 0, g_zeroDigit, g_zeroDigit + 1, scale - count, first, last, options, decimalWord);
+    return format_fixed(sink, mantissa < 0, first, last - scale, 0, last - scale, last, options, decimalWord);
+}
+
+
+/**
+ * @brief Writes the shortest representation of @p value that reads back to it, in scientific notation
+ */
+static size_t shortest_scientific(double value, char (&buffer)[32])
+{
+#if RMGR_NSFR_HAS_TO_CHARS_DOUBLE
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::scientific);
+    assert(result.ec == std::errc());
+    return size_t(result.ptr - buffer);
+#else
+    // Without std::to_chars(), look for the lowest precision that round trips
+    for (int precision = 0; ; ++precision)
+    {
+        const int length = snprintf(buffer, sizeof(buffer), "%.*e", precision, value);
+        if (precision >= std::numeric_limits<double>::max_digits10 - 1 || strtod(buffer, nullptr) == value)
+            return size_t(length);
+    }
+#endif
+}
+
+
+/**
+ * @brief Spells out the shortest decimal representation of @p value that reads back to it
+ */
+template<typename Sink>
+static std::errc format_double(Sink& sink, double value, unsigned options, const char* decimalWord)
+{
+    if (!std::isfinite(value))
+        return std::errc::invalid_argument;
+
+    // Split "-d.ddde+xx" into its sign, significant digits and exponent
+    char scientific[32];
+    const char* const end = scientific + shortest_scientific(value, scientific);
+    const char* cur = scientific;
+    const bool negative = (*cur == '-');
+    char   digits[std::numeric_limits<double>::max_digits10];
+    size_t count = 0;
+    for (; *cur != 'e'; ++cur)
+        if (*cur >= '0' && *cur <= '9')
+            digits[count++] = *cur;
+    const bool negativeExponent = (*++cur == '-');
+    int exponent = 0;
+    for (++cur; cur != end; ++cur)
+        exponent = exponent * 10 + (*cur - '0');
+    if (negativeExponent)
+        return format_fixed(sink, negative, g_zeroDigit, g_zeroDigit + 1, size_t(exponent - 1), digits, digits + count, options, decimalWord);
+
+    // The integer part may have to be padded with zeros
+    char integer[std::numeric_limits<double>::max_exponent10 + 1];
+    const size_t integerLength = size_t(exponent) + 1u;
+    const size_t integerDigits = (count < integerLength) ? count : integerLength;
+    memcpy(integer, digits, integerDigits);
+    memset(integer + integerDigits, '0', integerLength - integerDigits);
+    return format_fixed(sink, negative, integer, integer + integerLength, 0, digits + integerDigits, digits + count, options, decimalWord);
+}
+
+
+//=================================================================================================
+// Amounts
+
+/**
+ * @brief Whether "de" is elided in front of @p word ("d'euros"), i.e. whether it starts with a vowel
+ *
+ * An initial h is considered aspirated, which is the case for most currencies, and an initial y is
+ * a consonant ("de yens").
+ */
+static bool elides_de(const char* word)
+{
+    const unsigned char c = static_cast<unsigned char>(word[0]);
+    if (c == 0xC3u) // Latin-1 supplement, made of vowels but for ç and ñ
+    {
+        const unsigned char next = static_cast<unsigned char>(word[1]) & ~0x20u;
+        return next != 0x87u && next != 0x91u;
+    }
+    return strchr("aeiouAEIOU", c) != nullptr && c != '\0';
+}
+
+
+/**
+ * @brief Spells out a number of things, the noun agreeing with the number
+ */
+template<typename Sink>
+static void format_quantity(Sink& sink, uintmax_t value, const char* singular, const char* plural, unsigned gender, unsigned options)
+{
+    const internal::Profile& profile = *internal::resolve_profile((options & ~FEMININE) | gender);
+    format(sink, value, profile.options, ProfileEngine(profile));
+    sink.append(internal::g_space);
+
+    // Nouns such as million are followed by "de": "un million d'euros", but "un million deux euros"
+    if (value % 1000000u == 0u && value != 0u)
+        sink.append(elides_de(plural) ? "d'" : "de ");
+    sink.append((value >= 2u) ? plural : singular);
+}
+
+
+template<typename Sink>
+static std::errc format_amount(Sink& sink, intmax_t amount, const currency& cur, unsigned options)
+{
+    // Ordinal amounts make no sense, and the subunits must fit the 32-bit divisor
+    if ((options & (ORDINAL | ORDINAL_SUFFIX | CARDINAL_AS_ORDINAL)) || cur.subunitDigits > 9u)
+        return std::errc::invalid_argument;
+
+    // Negating in the unsigned domain, as -INTMAX_MIN overflows
+    uintmax_t magnitude = static_cast<uintmax_t>(amount);
+    if (amount < 0)
+    {
+        sink.append(internal::g_minus);
+        sink.append(internal::g_space);
+        magnitude = 0u - magnitude;
+    }
+
+    uint32_t divisor = 1;
+    for (unsigned i = 0; i < cur.subunitDigits; ++i)
+        divisor *= 10u;
+    const uintmax_t units    = magnitude / divisor;
+    const uint32_t  subunits = static_cast<uint32_t>(magnitude % divisor);
+
+    if (units != 0u || subunits == 0u)
+        format_quantity(sink, units, cur.unit, cur.units, cur.unitGender, options);
+    if (subunits != 0u)
+    {
+        if (units != 0u)
+            sink.append(" et ", 4);
+        format_quantity(sink, subunits, cur.subunit, cur.subunits, cur.subunitGender, options);
+    }
+    return std::errc();
+}
+
+
+//=================================================================================================
+// Counters
+
+/**
+ * @brief Some of the groups of a counter, the most significant one being non-zero
+ */
+struct CounterGroups
+{
+    const unsigned* values;
+    size_t          count;
+
+    CounterGroups(const unsigned* values_, size_t count_): values(values_), count(count_) {}
+
+    size_t size() const {return count;}
+
+    unsigned operator[](size_t i) const {return values[i];}
+
+    template<typename Sink>
+    void append_scale(Sink& sink, size_t i) const
+    {
+        sink.append(Words::numerals[i].cardinal);
+    }
+};
+
+
+/**
+ * @brief Engine that records where the spelling of each group starts
+ */
+struct CounterEngine: ProfileEngine
+{
+    size_t* starts;
+
+    CounterEngine(const internal::Profile& profile_, size_t* starts_): ProfileEngine(profile_), starts(starts_) {}
+
+    void begin_group(StringSink& sink, size_t i) const {starts[i] = sink.str.size();}
+};
+
+
+counter::counter(uintmax_t value, unsigned options):
+    m_profile(internal::resolve_profile(options)),
+    m_value(0)
+{
+    reset(value);
+}
+
+
+unsigned counter::options() const
+{
+    return m_profile->options;
+}
+
+
+void counter::reset(uintmax_t value)
+{
+    m_value = value;
+    memset(m_groups, 0, sizeof(m_groups));
+    unsigned count = 0;
+    do
+    {
+        m_groups[count++] = static_cast<unsigned>(value % 1000u);
+        value /= 1000u;
+    }
+    while (value != 0u);
+
+    m_spelling.clear();
+    if (m_value <= 2u || (m_profile->options & ORDINAL_SUFFIX))
+    {
+        // The special cases
+        StringSink sink(m_spelling);
+        format(sink, m_value, m_profile->options, ProfileEngine(*m_profile));
+    }
+    else
+        format_from(count - 1);
+}
+
+
+/**
+ * @brief Spells out groups @p top and below, the spelling of the groups above being already there
+ */
+void counter::format_from(unsigned top)
+{
+    assert(m_groups[top] != 0u);
+    StringSink sink(m_spelling);
+    internal::format_groups(sink, CounterGroups(m_groups, top + 1u), internal::number_options(m_profile->options), CounterEngine(*m_profile, m_starts));
+}
+
+
+counter& counter::operator++()
+{
+    const uintmax_t previous = m_value;
+    if (previous <= 2u || previous == UINTMAX_MAX || (m_profile->options & ORDINAL_SUFFIX))
+    {
+        reset(previous + 1u);
+        return *this;
+    }
+    ++m_value;
+
+    unsigned previousLowest = 0;
+    while (m_groups[previousLowest] == 0u)
+        ++previousLowest;
+
+    unsigned carry = 0;
+    while (m_groups[carry] == 999u)
+        m_groups[carry++] = 0;
+    ++m_groups[carry];
+
+    // The spelling of a group only depends on its value, on whether it is the lowest non-zero one
+    // and, for the thousands when using "onze cents", on the hundreds
+    unsigned top = (carry > previousLowest) ? carry : previousLowest;
+    if (top == 0u && (m_profile->options & CENT_1100_1999) && m_groups[1] == 1u)
+        top = 1;
+
+    // Cut the spelling where the previous one of the highest rewritten group started, or where the
+    // one below it did if that group was zero
+    const unsigned cut = (top == carry && m_groups[carry] == 1u && carry != 0u) ? carry - 1u : top;
+    m_spelling.resize(m_starts[cut]);
+    format_from(top);
+    return *this;
+}
+
+
+//=================================================================================================
+// Caches
+
+/**
+ * @brief The key of a cached spelling
+ */
+struct CacheKey
+{
+    uintmax_t magnitude;
+    unsigned  options;   ///< Normalized, with CACHE_NEGATIVE for negative values
+
+    bool operator==(const CacheKey& other) const {return magnitude == other.magnitude && options == other.options;}
+};
+
+static const unsigned CACHE_NEGATIVE = 0x80000000u;
+
+
+/**
+ * @brief Mixes the bits of a key, both to pick its shard and within the shard's map
+ */
+static uint64_t hash_key(const CacheKey& key)
+{
+    // The finalizer of SplitMix64
+    uint64_t h = uint64_t(key.magnitude) ^ (uint64_t(key.options) << 40);
+    h = (h ^ (h >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    h = (h ^ (h >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return h ^ (h >> 31);
+}
+
+
+struct CacheKeyHash
+{
+    size_t operator()(const CacheKey& key) const {return size_t(hash_key(key));}
+};
+
+
+struct internal::CacheShard
+{
+    struct Entry
+    {
+        CacheKey        key;
+        cached_spelling spelling;
+        bool            referenced; ///< Whether the entry was used since the clock hand last passed by
+    };
+
+    mutable std::mutex                                 mutex;
+    std::unordered_map<CacheKey, size_t, CacheKeyHash> indices; ///< Into entries
+    std::vector<Entry>                                 entries;
+    size_t                                             capacity;
+    size_t                                             hand;
+    std::atomic<uint64_t>                              hits;
+    std::atomic<uint64_t>                              misses;
+
+    CacheShard(): capacity(0), hand(0), hits(0), misses(0) {}
+};
+
+
+spelling_cache::spelling_cache(size_t capacity, unsigned shardCount):
+    m_shards(new internal::CacheShard[(shardCount != 0u) ? shardCount : 1u]),
+    m_shardCount((shardCount != 0u) ? shardCount : 1u)
+{
+    const size_t shardCapacity = (capacity + m_shardCount - 1u) / m_shardCount;
+    for (unsigned i = 0; i < m_shardCount; ++i)
+    {
+        m_shards[i].capacity = (shardCapacity != 0u) ? shardCapacity : 1u;
+        m_shards[i].indices.reserve(m_shards[i].capacity);
+    }
+}
+
+
+spelling_cache::~spelling_cache()
+{
+}
+
+
+cached_spelling spelling_cache::find(intmax_t value, unsigned options)
+{
+    // Negating in the unsigned domain, as -INTMAX_MIN overflows
+    const uintmax_t magnitude = static_cast<uintmax_t>(value);
+    return (value < 0) ? find(true, 0u - magnitude, options) : find(false, magnitude, options);
+}
+
+
+cached_spelling spelling_cache::find(uintmax_t value, unsigned options)
+{
+    return find(false, value, options);
+}
+
+
+cached_spelling spelling_cache::find(bool negative, uintmax_t magnitude, unsigned options)
+{
+    options = normalized_options(options);
+    const CacheKey key = {magnitude, negative ? (options | CACHE_NEGATIVE) : options};
+    const uint64_t hash = hash_key(key);
+    internal::CacheShard& shard = m_shards[size_t((hash >> 32) % m_shardCount)];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.indices.find(key);
+        if (it != shard.indices.end())
+        {
+            internal::CacheShard::Entry& entry = shard.entries[it->second];
+            entry.referenced = true;
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return entry.spelling;
+        }
+    }
+
+    // Spell out without holding the lock, another thread may well do the same meanwhile
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+    const cached_spelling spelling = std::make_shared<const std::string>(negative
+        ? internal::spell_out(-static_cast<intmax_t>(magnitude - 1u) - 1, options)
+        : internal::spell_out(magnitude, options));
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.indices.find(key) != shard.indices.end())
+        return spelling;
+    if (shard.entries.size() < shard.capacity)
+    {
+        shard.indices.emplace(key, shard.entries.size());
+        shard.entries.push_back(internal::CacheShard::Entry{key, spelling, false});
+        return spelling;
+    }
+
+    // Evict the first entry the hand finds unused since its last pass, giving others a second chance
+    while (shard.entries[shard.hand].referenced)
+    {
+        shard.entries[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1u) % shard.entries.size();
+    }
+    internal::CacheShard::Entry& victim = shard.entries[shard.hand];
+#if defined(__cpp_lib_node_extract)
+    // Reusing the node saves a memory allocation
+    auto node = shard.indices.extract(victim.key);
+    node.key() = key;
+    shard.indices.insert(std::move(node));
+#else
+    shard.indices.erase(victim.key);
+    shard.indices.emplace(key, shard.hand);
+#endif
+    victim.key      = key;
+    victim.spelling = spelling;
+    shard.hand      = (shard.hand + 1u) % shard.entries.size();
+    return spelling;
+}
+
+
+uint64_t spelling_cache::hits() const
+{
+    uint64_t hits = 0;
+    for (unsigned i = 0; i < m_shardCount; ++i)
+        hits += m_shards[i].hits.load(std::memory_order_relaxed);
+    return hits;
+}
+
+
+uint64_t spelling_cache::misses() const
+{
+    uint64_t misses = 0;
+    for (unsigned i = 0; i < m_shardCount; ++i)
+        misses += m_shards[i].misses.load(std::memory_order_relaxed);
+    return misses;
+}
+
+
+size_t spelling_cache::size() const
+{
+    size_t size = 0;
+    for (unsigned i = 0; i < m_shardCount; ++i)
+    {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        size += m_shards[i].entries.size();
+    }
+    return size;
+}
+
+
+size_t spelling_cache::capacity() const
+{
+    return m_shards[0].capacity * m_shardCount;
+}
+
+
+void spelling_cache::clear()
+{
+    for (unsigned i = 0; i < m_shardCount; ++i)
+    {
+        internal::CacheShard&       shard = m_shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.indices.clear();
+        shard.entries.clear();
+        shard.hand = 0;
+    }
+}
+
+
+//=================================================================================================
+// Dictionaries
+
+static const char     DICTIONARY_MAGIC[8]   = {'N', 'S', 'F', 'R', 'D', 'I', 'C', 'T'};
+static const uint32_t DICTIONARY_VERSION    = 1;
+static const uint32_t DICTIONARY_BYTE_ORDER = 0x01020304; ///< As written by the machine that generated the file
+
+/**
+ * @brief The header of a dictionary file, followed by `profileCount` profiles
+ */
+struct DictionaryHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t valueCount;
+    uint32_t profileCount;
+    uint32_t reserved;
+};
+
+
+struct DictionaryProfile
+{
+    uint32_t options;     ///< Normalized
+    uint32_t reserved;
+    uint64_t indexOffset; ///< From the start of the file, to `valueCount+1` 32-bit offsets within the pool
+    uint64_t poolOffset;  ///< From the start of the file, to the spellings back-to-back
+    uint64_t poolSize;
+};
+
+
+std::errc write_dictionary(const char* path, uintmax_t valueCount, const unsigned* options, size_t profileCount)
+{
+    // Every spelling takes at least 2 bytes ("un") of a pool whose offsets are 32-bit, so larger counts
+    // could only fail, after allocating and spelling gigabytes
+    if (valueCount > UINT32_MAX / 2u)
+        return std::errc::value_too_large;
+
+    // Spell everything out first, so that no file is left behind on failure but system ones
+    std::vector<DictionaryProfile>     profiles(profileCount);
+    std::vector<std::vector<uint32_t>> indices(profileCount);
+    std::vector<std::string>           pools(profileCount);
+    uint64_t fileOffset = sizeof(DictionaryHeader) + profileCount * sizeof(DictionaryProfile);
+    for (size_t p = 0; p < profileCount; ++p)
+    {
+        const internal::Profile& profile = *internal::resolve_profile(options[p]);
+        std::vector<uint32_t>&   index   = indices[p];
+        std::string&             pool    = pools[p];
+        index.reserve(size_t(valueCount) + 1u);
+        for (uintmax_t value = 0; value < valueCount; ++value)
+        {
+            index.push_back(static_cast<uint32_t>(pool.size()));
+            append_to_impl(profile, pool, value);
+            if (pool.size() > UINT32_MAX)
+                return std::errc::value_too_large;
+        }
+        index.push_back(static_cast<uint32_t>(pool.size()));
+
+        DictionaryProfile& entry = profiles[p];
+        entry.options     = normalized_options(options[p]);
+        entry.reserved    = 0;
+        entry.indexOffset = fileOffset;
+        entry.poolOffset  = entry.indexOffset + index.size() * sizeof(uint32_t);
+        entry.poolSize    = pool.size();
+        fileOffset        = (entry.poolOffset + entry.poolSize + 7u) & ~uint64_t(7u); // Keeps indices aligned
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+        return std::errc(errno);
+
+    DictionaryHeader header;
+    memcpy(header.magic, DICTIONARY_MAGIC, sizeof(header.magic));
+    header.version      = DICTIONARY_VERSION;
+    header.byteOrder    = DICTIONARY_BYTE_ORDER;
+    header.valueCount   = valueCount;
+    header.profileCount = static_cast<uint32_t>(profileCount);
+    header.reserved     = 0;
+
+    static const char padding[8] = {};
+    bool ok =    fwrite(&header, sizeof(header), 1, file) == 1u
+              && (profileCount == 0u || fwrite(profiles.data(), sizeof(DictionaryProfile), profileCount, file) == profileCount);
+    for (size_t p = 0; ok && p < profileCount; ++p)
+    {
+        const size_t paddingSize = size_t((8u - (profiles[p].poolOffset + profiles[p].poolSize) % 8u) % 8u);
+        ok =    fwrite(indices[p].data(), sizeof(uint32_t), indices[p].size(), file) == indices[p].size()
+             && fwrite(pools[p].data(), 1, pools[p].size(), file) == pools[p].size()
+             && fwrite(padding, 1, paddingSize, file) == paddingSize;
+    }
+    const int error = ok ? 0 : errno;
+    if (fclose(file) != 0 && ok)
+        return std::errc(errno);
+    return ok ? std::errc() : std::errc(error);
+}
+
+
+dictionary::dictionary():
+    m_data(nullptr),
+    m_size(0),
+    m_mapping(nullptr)
+{
+}
+
+
+dictionary::~dictionary()
+{
+    close();
+}
+
+
+dictionary::dictionary(dictionary&& other):
+    m_data(other.m_data),
+    m_size(other.m_size),
+    m_mapping(other.m_mapping)
+{
+    other.m_data    = nullptr;
+    other.m_size    = 0;
+    other.m_mapping = nullptr;
+}
+
+
+dictionary& dictionary::operator=(dictionary&& other)
+{
+    if (this != &other)
+    {
+        close();
+        std::swap(m_data,    other.m_data);
+        std::swap(m_size,    other.m_size);
+        std::swap(m_mapping, other.m_mapping);
+    }
+    return *this;
+}
+
+
+std::errc dictionary::open(const char* path)
+{
+    close();
+
+#if defined(_WIN32)
+    const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return std::errc::no_such_file_or_directory;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || uint64_t(fileSize.QuadPart) < sizeof(DictionaryHeader) || uint64_t(fileSize.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(file);
+        return std::errc::invalid_argument;
+    }
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+        return std::errc::not_enough_memory;
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        return std::errc::not_enough_memory;
+    }
+    m_mapping = mapping;
+    m_size    = size_t(fileSize.QuadPart);
+#else
+    const int file = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        return std::errc(errno);
+    struct stat status;
+    if (fstat(file, &status) != 0 || uint64_t(status.st_size) < sizeof(DictionaryHeader) || uint64_t(status.st_size) > SIZE_MAX)
+    {
+        ::close(file);
+        return std::errc::invalid_argument;
+    }
+    void* const data = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED)
+        return std::errc(errno);
+    m_size = size_t(status.st_size);
+#endif
+    m_data = static_cast<const unsigned char*>(data);
+
+    // Only the header is checked, the rest is used as is
+    DictionaryHeader header;
+    memcpy(&header, m_data, sizeof(header));
+    std::errc ec = std::errc();
+    if (memcmp(header.magic, DICTIONARY_MAGIC, sizeof(header.magic)) != 0)
+        ec = std::errc::invalid_argument;
+    else if (header.version != DICTIONARY_VERSION || header.byteOrder != DICTIONARY_BYTE_ORDER)
+        ec = std::errc::not_supported;
+    else if (header.profileCount > (m_size - sizeof(header)) / sizeof(DictionaryProfile))
+        ec = std::errc::invalid_argument;
+    for (uint32_t p = 0; ec == std::errc() && p < header.profileCount; ++p)
+    {
+        DictionaryProfile profile;
+        memcpy(&profile, m_data + sizeof(header) + p * sizeof(profile), sizeof(profile));
+        if (   header.valueCount >= m_size / sizeof(uint32_t)
+            || profile.indexOffset % sizeof(uint32_t) != 0u
+            || profile.indexOffset > m_size || (header.valueCount + 1u) * sizeof(uint32_t) > m_size - profile.indexOffset
+            || profile.poolOffset  > m_size || profile.poolSize > m_size - profile.poolOffset)
+        {
+            ec = std::errc::invalid_argument;
+        }
+    }
+    if (ec != std::errc())
+        close();
+    return ec;
+}
+
+
+void dictionary::close()
+{
+    if (m_data == nullptr)
+        return;
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+#else
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    m_data    = nullptr;
+    m_size    = 0;
+    m_mapping = nullptr;
+}
+
+
+uintmax_t dictionary::size() const
+{
+    if (m_data == nullptr)
+        return 0;
+    return reinterpret_cast<const DictionaryHeader*>(m_data)->valueCount;
+}
+
+
+/**
+ * @brief Finds the profile with the given options, nullptr if there is none
+ */
+static const DictionaryProfile* find_profile(const unsigned char* data, unsigned options)
+{
+    if (data == nullptr)
+        return nullptr;
+    const DictionaryHeader*  header   = reinterpret_cast<const DictionaryHeader*>(data);
+    const DictionaryProfile* profiles = reinterpret_cast<const DictionaryProfile*>(data + sizeof(DictionaryHeader));
+    options = normalized_options(options);
+    for (uint32_t p = 0; p < header->profileCount; ++p)
+        if (profiles[p].options == options)
+            return &profiles[p];
+    return nullptr;
+}
+
+
+bool dictionary::contains(unsigned options) const
+{
+    return find_profile(m_data, options) != nullptr;
+}
+
+
+bool dictionary::find(uintmax_t value, unsigned options, const char*& spelling, size_t& length) const
+{
+    const DictionaryProfile* profile = find_profile(m_data, options);
+    if (profile == nullptr || value >= size())
+        return false;
+
+    // Offsets are checked against the pool, in case the file is corrupt
+    const uint32_t* index = reinterpret_cast<const uint32_t*>(m_data + profile->indexOffset);
+    const uint32_t  begin = index[value];
+    const uint32_t  end   = index[value + 1u];
+    if (begin > end || end > profile->poolSize)
+        return false;
+    spelling = reinterpret_cast<const char*>(m_data + profile->poolOffset + begin);
+    length   = end - begin;
+    return true;
+}
+
+
+//=================================================================================================
+// Tokens
+
+/**
+ * @brief Sink that records which words are appended rather than their text
+ */
+struct TokenSink
+{
+    token* cur;
+    token* last;
+
+    TokenSink(token* first, token* last_): cur(first), last(last_) {}
+
+    void append(WordRef word)
+    {
+        assert(cur != last);
+        *cur++ = static_cast<token>(word.id);
+    }
+};
+
+
+template<typename Integer>
+static size_t spell_tokens_impl(Integer value, unsigned options, token* tokens)
+{
+    TokenSink sink(tokens, tokens + internal::MAX_TOKEN_COUNT);
+    format(sink, value, options, internal::RuleEngine());
+    return size_t(sink.cur - tokens);
+}
+
+
+size_t internal::spell_tokens(intmax_t value, unsigned options, token* tokens)
+{
+    return spell_tokens_impl(value, options, tokens);
+}
+
+
+size_t internal::spell_tokens(uintmax_t value, unsigned options, token* tokens)
+{
+    return spell_tokens_impl(value, options, tokens);
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+size_t internal::spell_tokens(int128_t value, unsigned options, token* tokens)
+{
+    return spell_tokens_impl(value, options, tokens);
+}
+
+
+size_t internal::spell_tokens(uint128_t value, unsigned options, token* tokens)
+{
+    return spell_tokens_impl(value, options, tokens);
+}
+#endif
+
+
+void internal::append_rendered(std::string& str, const token* first, const token* last)
+{
+    // The lengths are known, so that the string is grown only once
+    size_t length = 0;
+    for (const token* t = first; t != last; ++t)
+    {
+        assert(size_t(*t) < sizeof(Words::tokens) / sizeof(Words::tokens[0]));
+        length += Words::tokens[size_t(*t)].length;
+    }
+    str.reserve(str.size() + length);
+
+    StringSink sink(str);
+    for (const token* t = first; t != last; ++t)
+        sink.append(Words::tokens[size_t(*t)]);
+}
+
+
+//=================================================================================================
+// Segments
+
+/**
+ * @brief Sink that records where the text lies instead of copying it
+ *
+ * Only the words of the pool and the group tables are ever appended, both of which live until the
+ * program exits. Segments beyond the capacity are only counted.
+ */
+struct SegmentSink
+{
+    spelled_segment* segments;
+    size_t           capacity;
+    size_t           count;
+
+    SegmentSink(spelled_segment* segments_, size_t capacity_): segments(segments_), capacity(capacity_), count(0) {}
+
+    void append(const char* str, size_t length)
+    {
+        if (count < capacity)
+        {
+            segments[count].data   = str;
+            segments[count].length = length;
+        }
+        ++count;
+    }
+
+    void append(WordRef word) {append(Words::pool + word.offset, word.length);}
+};
+
+
+template<typename Integer>
+static size_t to_segments_impl(spelled_segment* segments, size_t capacity, Integer value, unsigned options)
+{
+    const internal::Profile& profile = *internal::resolve_profile(options);
+    SegmentSink sink(segments, capacity);
+    format(sink, value, profile.options, ProfileEngine(profile));
+    return sink.count;
+}
+
+
+size_t internal::to_segments(spelled_segment* segments, size_t capacity, intmax_t value, unsigned options)
+{
+    return to_segments_impl(segments, capacity, value, options);
+}
+
+
+size_t internal::to_segments(spelled_segment* segments, size_t capacity, uintmax_t value, unsigned options)
+{
+    return to_segments_impl(segments, capacity, value, options);
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+size_t internal::to_segments(spelled_segment* segments, size_t capacity, int128_t value, unsigned options)
+{
+    return to_segments_impl(segments, capacity, value, options);
+}
+
+
+size_t internal::to_segments(spelled_segment* segments, size_t capacity, uint128_t value, unsigned options)
+{
+    return to_segments_impl(segments, capacity, value, options);
+}
+#endif
+
+
+//=================================================================================================
+// Parallel batches
+
+/**
+ * @brief The chunks a worker owns, from which the other workers may steal
+ *
+ * The owner takes chunks from the front and thieves from the back. Both ends are packed into a
+ * single atomic, so that either side only needs a compare-and-swap.
+ */
+struct ChunkRange
+{
+    std::atomic<uint64_t> range;                                 ///< The next chunk in the low 32 bits, the end in the high ones
+    char                  padding[64 - sizeof(std::atomic<uint64_t>)]; ///< Keeps the ranges of different workers on different cache lines
+
+    void assign(uint32_t first, uint32_t last)
+    {
+        range.store((uint64_t(last) << 32) | first, std::memory_order_relaxed);
+    }
+
+    bool pop_front(uint32_t& chunk)
+    {
+        uint64_t r = range.load(std::memory_order_relaxed);
+        while (uint32_t(r) < uint32_t(r >> 32))
+        {
+            if (range.compare_exchange_weak(r, r + 1u, std::memory_order_relaxed))
+            {
+                chunk = uint32_t(r);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool pop_back(uint32_t& chunk)
+    {
+        uint64_t r = range.load(std::memory_order_relaxed);
+        while (uint32_t(r) < uint32_t(r >> 32))
+        {
+            if (range.compare_exchange_weak(r, r - (uint64_t(1) << 32), std::memory_order_relaxed))
+            {
+                chunk = uint32_t(r >> 32) - 1u;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+/**
+ * @brief The memory a worker spells its chunks out into
+ *
+ * It is never zeroed nor moved: only the pages actually written to are ever touched.
+ */
+struct WorkerArena
+{
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char*                                cur;
+    char*                                end;
+
+    WorkerArena(): cur(nullptr), end(nullptr) {}
+
+    /** @brief Makes sure the next @p size bytes are contiguous */
+    void reserve(size_t size)
+    {
+        if (size_t(end - cur) < size)
+        {
+            const size_t blockSize = std::max(size, size_t(4) << 20);
+            blocks.emplace_back(new char[blockSize]);
+            cur = blocks.back().get();
+            end = cur + blockSize;
+        }
+    }
+};
+
+
+/**
+ * @brief Where the spellings of a chunk lie, within the arena of the worker that spelled it out
+ */
+struct ChunkSpellings
+{
+    const char* bytes;
+    size_t      byteCount;
+};
+
+
+/**
+ * @brief Calls `process(worker, chunk)` for all chunks within [0; @p chunkCount), on @p threadCount threads
+ *
+ * Chunks are first split evenly between the workers, each one stealing from the others once done
+ * with its own. The first exception thrown by a worker is rethrown once all threads are joined.
+ */
+template<typename Process>
+static void run_workers(ChunkRange* ranges, uint32_t threadCount, uint32_t chunkCount, const Process& process)
+{
+    for (uint32_t w = 0; w < threadCount; ++w)
+        ranges[w].assign(uint32_t(uint64_t(chunkCount) * w / threadCount), uint32_t(uint64_t(chunkCount) * (w + 1u) / threadCount));
+
+    std::vector<std::exception_ptr> exceptions(threadCount);
+    auto work = [&](uint32_t w)
+    {
+        try
+        {
+            uint32_t chunk = 0;
+            for (;;)
+            {
+                bool found = ranges[w].pop_front(chunk);
+                for (uint32_t v = 1; !found && v < threadCount; ++v)
+                    found = ranges[(w + v) % threadCount].pop_back(chunk);
+                if (!found)
+                    break;
+                process(w, chunk);
+            }
+        }
+        catch (...)
+        {
+            exceptions[w] = std::current_exception();
+        }
+    };
+
+    // The calling thread is worker 0
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1u);
+    for (uint32_t w = 1; w < threadCount; ++w)
+        threads.emplace_back(work, w);
+    work(0);
+    for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+
+    for (uint32_t w = 0; w < threadCount; ++w)
+    {
+        if (exceptions[w])
+            std::rethrow_exception(exceptions[w]);
+    }
+}
+
+
+void internal::spell_out_parallel(const ParallelBatch& batch, unsigned threadCount)
+{
+    if (threadCount == 0u)
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Several chunks per thread so that stealing can balance the load, but large enough to make
+    // scheduling negligible, and few enough to be numbered with 32 bits
+    size_t chunkSize = std::min(std::max(batch.count / (size_t(threadCount) * 16u), size_t(256)), size_t(16384));
+    chunkSize = std::max(chunkSize, batch.count / UINT32_MAX + 1u);
+    const uint32_t chunkCount = uint32_t((batch.count + chunkSize - 1u) / chunkSize);
+    threadCount = std::max(std::min(threadCount, chunkCount), 1u);
+
+    // The end of each spelling is first relative to the start of its chunk
+    std::unique_ptr<ChunkRange[]> ranges(new ChunkRange[threadCount]);
+    std::vector<WorkerArena>      arenas(threadCount);
+    std::vector<ChunkSpellings>   chunks(chunkCount);
+    std::unique_ptr<uint32_t[]>   relativeEnds(new uint32_t[batch.count]);
+
+    // Spell each chunk out into the arena of the worker that takes it
+    run_workers(ranges.get(), threadCount, chunkCount, [&](uint32_t w, uint32_t c)
+    {
+        WorkerArena& arena = arenas[w];
+        const size_t first = size_t(c) * chunkSize;
+        const size_t last  = std::min(first + chunkSize, batch.count);
+        arena.reserve((last - first) * batch.maxLength);
+        char* const begin = arena.cur;
+        for (size_t i = first; i < last; ++i)
+        {
+            const to_words_result result = batch.write(batch.source, i, arena.cur, arena.cur + batch.maxLength);
+            if (result.ec == std::errc())
+                arena.cur = result.ptr;
+            relativeEnds[i] = static_cast<uint32_t>(arena.cur - begin);
+        }
+        chunks[c].bytes     = begin;
+        chunks[c].byteCount = size_t(arena.cur - begin);
+    });
+
+    // Where each chunk goes within the column, in input order
+    std::vector<size_t> starts(chunkCount);
+    size_t byteCount = 0;
+    for (uint32_t c = 0; c < chunkCount; ++c)
+    {
+        starts[c]  = byteCount;
+        byteCount += chunks[c].byteCount;
+    }
+
+    char*        bytes = nullptr;
+    size_t*      ends  = nullptr;
+    const size_t base  = batch.append(batch.column, batch.count, byteCount, bytes, ends);
+
+    // Stitch the arenas together
+    run_workers(ranges.get(), threadCount, chunkCount, [&](uint32_t, uint32_t c)
+    {
+        const ChunkSpellings& chunk = chunks[c];
+        const size_t          first = size_t(c) * chunkSize;
+        const size_t          last  = std::min(first + chunkSize, batch.count);
+        if (chunk.byteCount != 0u)
+            memcpy(bytes + starts[c], chunk.bytes, chunk.byteCount);
+        for (size_t i = first; i < last; ++i)
+            ends[i] = base + starts[c] + relativeEnds[i];
+    });
+}
+
+
+//=================================================================================================
+// Normalization
+
+static bool is_digit(int c)
+{
+    return unsigned(c - '0') < 10u;
+}
+
+
+/**
+ * @brief Tells whether a byte may be part of a word, in which case a '-' before it is not a sign
+ *        and an ordinal abbreviation can't end there
+ *
+ * Besides ASCII letters and digits, 0xC3 to 0xC5 lead the UTF-8 sequences of the accented letters
+ * of French (U+00C0 to U+017F).
+ */
+static bool is_word_byte(int c)
+{
+    return is_digit(c) || unsigned((c | 0x20) - 'a') < 26u || (c >= 0xC3 && c <= 0xC5);
+}
+
+
+#if RMGR_NSFR_HAS_SSE2
+static unsigned lowest_bit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return unsigned(index);
+#else
+    return unsigned(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+
+#if RMGR_NSFR_HAS_SSE2
+/**
+ * @brief Sets the bytes of the result where the 16 bytes at @p p are digits
+ */
+static __m128i digit_bytes(const char* p)
+{
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return _mm_cmplt_epi8(_mm_add_epi8(bytes, _mm_set1_epi8(char(0x80 - '0'))), _mm_set1_epi8(char(0x80 + 10)));
+}
+#endif
+
+
+/**
+ * @brief Finds the first decimal digit of [@p first; @p last), or @p last if there is none
+ *
+ * Adding 0x80 - '0' to the bytes maps the digits to [-128; -119], so that a single signed
+ * comparison tells them apart, 64, 32 or 16 bytes at a time. Without SIMD, 8 bytes at a time are
+ * skipped as long as none of them is a digit.
+ */
+static const char* find_digit(const char* first, const char* last)
+{
+#if RMGR_NSFR_HAS_AVX2
+    const __m256i shift32 = _mm256_set1_epi8(char(0x80 - '0'));
+    const __m256i limit32 = _mm256_set1_epi8(char(0x80 + 10));
+    for (; last - first >= 32; first += 32)
+    {
+        const __m256i bytes = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), shift32);
+        const uint32_t mask = uint32_t(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit32, bytes)));
+        if (mask != 0u)
+            return first + lowest_bit(mask);
+    }
+#endif
+#if RMGR_NSFR_HAS_SSE2
+    // Digits are rare in most texts, so skip 64 bytes at a time
+    for (; last - first >= 64; first += 64)
+    {
+        const __m128i digits = _mm_or_si128(_mm_or_si128(digit_bytes(first),      digit_bytes(first + 16)),
+                                            _mm_or_si128(digit_bytes(first + 32), digit_bytes(first + 48)));
+        if (_mm_movemask_epi8(digits) != 0)
+            break;
+    }
+    for (; last - first >= 16; first += 16)
+    {
+        const uint32_t mask = uint32_t(_mm_movemask_epi8(digit_bytes(first)));
+        if (mask != 0u)
+            return first + lowest_bit(mask);
+    }
+#else
+    for (; last - first >= 8; first += 8)
+    {
+        uint64_t word;
+        memcpy(&word, first, sizeof(word));
+        const uint64_t low      = word & UINT64_C(0x7F7F7F7F7F7F7F7F);
+        const uint64_t atLeast0 = low + UINT64_C(0x5050505050505050); // High bit set from '0' on
+        const uint64_t above9   = low + UINT64_C(0x4646464646464646); // High bit set from ':' on
+        if ((atLeast0 & ~above9 & ~word & UINT64_C(0x8080808080808080)) != 0u)
+            break;
+    }
+#endif
+    while (first != last && !is_digit(static_cast<unsigned char>(*first)))
+        ++first;
+    return first;
+}
+
+
+static size_t separator_length(unsigned char firstByte)
+{
+    return (firstByte == ' ') ? 1u : (firstByte == 0xC2) ? 2u : 3u;
+}
+
+
+/**
+ * @brief An ordinal abbreviation, such as "er" in "1er"
+ */
+struct OrdinalAbbreviation
+{
+    const char* text;
+    size_t      length;
+    unsigned    value;   ///< The number it follows, 0 for any number but 1
+    unsigned    options; ///< The options it spells its number with, replacing the gender if `value` is not 0
+};
+
+
+static const OrdinalAbbreviation g_ordinalAbbreviations[] =
+{
+    {"er",             2, 1, ORDINAL},
+    {"re",             2, 1, ORDINAL | FEMININE},
+    {"\xC3\xA8re",     4, 1, ORDINAL | FEMININE},
+    {"nd",             2, 2, ORDINAL | SECOND},
+    {"nde",            3, 2, ORDINAL | SECOND | FEMININE},
+    {"e",              1, 0, ORDINAL},
+    {"eme",            3, 0, ORDINAL},
+    {"\xC3\xA8me",     4, 0, ORDINAL},
+    {"ieme",           4, 0, ORDINAL},
+    {"i\xC3\xA8me",    5, 0, ORDINAL},
+};
+
+
+/**
+ * @brief Finds the abbreviation that is @p str or, if @p prefix is set, one that starts with it
+ */
+static const OrdinalAbbreviation* find_ordinal_abbreviation(const char* str, size_t length, bool prefix)
+{
+    for (const OrdinalAbbreviation& abbreviation: g_ordinalAbbreviations)
+        if ((prefix ? abbreviation.length >= length : abbreviation.length == length) && memcmp(abbreviation.text, str, length) == 0)
+            return &abbreviation;
+    return nullptr;
+}
+
+
+/**
+ * @brief Returns 1 or 2 if the digits of [@p first; @p last) are that number, 0 otherwise
+ */
+static unsigned small_value(const char* first, const char* last)
+{
+    unsigned value = 0;
+    for (; first != last; ++first)
+    {
+        if (!is_digit(static_cast<unsigned char>(*first)) || (*first == '0' && value == 0u))
+            continue;
+        if (value != 0u)
+            return 0;
+        value = unsigned(*first - '0');
+    }
+    return (value <= 2u) ? value : 0u;
+}
+
+
+normalizer::normalizer(write_function write, void* context, unsigned options):
+    m_write(write),
+    m_context(context),
+    m_options(options & ~(ORDINAL | CARDINAL_AS_ORDINAL | ORDINAL_SUFFIX | SECOND)),
+    m_state(TEXT),
+    m_negative(false),
+    m_minusHeld(false),
+    m_previous(' '),
+    m_separator(0),
+    m_groupLength(0),
+    m_committed(0)
+{
+}
+
+
+void normalizer::feed(const char* data, size_t size)
+{
+    process(data, data + size);
+}
+
+
+void normalizer::finish()
+{
+    while (m_state != TEXT)
+        process_byte(-1);
+    if (m_minusHeld)
+    {
+        m_minusHeld = false;
+        write("-", 1);
+    }
+    m_previous = ' ';
+}
+
+
+void normalizer::write(const char* str, size_t length)
+{
+    if (length != 0u)
+    {
+        m_write(m_context, str, length);
+        m_previous = static_cast<unsigned char>(str[length - 1]);
+    }
+}
+
+
+void normalizer::process(const char* first, const char* last)
+{
+    while (first != last)
+    {
+        if (m_state == TEXT)
+            first = process_text(first, last);
+        else if (m_state == DIGITS && m_separator == 0u && is_digit(static_cast<unsigned char>(*first)))
+        {
+            // The digits before any separator all belong to the number, no need to go one by one
+            const char* digitsEnd = first + 1;
+            while (digitsEnd != last && is_digit(static_cast<unsigned char>(*digitsEnd)))
+                ++digitsEnd;
+            m_pending.append(first, digitsEnd);
+            m_groupLength += size_t(digitsEnd - first);
+            m_committed    = m_pending.size();
+            first          = digitsEnd;
+        }
+        else if (process_byte(static_cast<unsigned char>(*first)))
+            ++first;
+    }
+}
+
+
+/**
+ * @brief Writes the text up to the next digit, which starts a number
+ *
+ * @return Where the number starts, or @p last
+ */
+const char* normalizer::process_text(const char* first, const char* last)
+{
+    const char* const digit = find_digit(first, last);
+    if (m_minusHeld)
+    {
+        m_minusHeld = false;
+        if (digit == first && !is_word_byte(m_previous))
+        {
+            begin_number(true);
+            return first;
+        }
+        write("-", 1);
+    }
+
+    // A '-' right before the digits is their sign, unless it follows a word. One that ends the
+    // chunk is held back, as digits may start the next one.
+    const char* textEnd = digit;
+    if (digit != first && digit[-1] == '-')
+    {
+        const int before = (digit - 1 != first) ? static_cast<unsigned char>(digit[-2]) : m_previous;
+        if (!is_word_byte(before))
+            --textEnd;
+    }
+    write(first, size_t(textEnd - first));
+
+    if (digit == last)
+        m_minusHeld = (textEnd != digit);
+    else
+        begin_number(textEnd != digit);
+    return digit;
+}
+
+
+void normalizer::begin_number(bool negative)
+{
+    m_state       = DIGITS;
+    m_negative    = negative;
+    m_separator   = 0;
+    m_groupLength = 0;
+    m_pending.clear();
+    if (negative)
+        m_pending += '-';
+    m_committed   = m_pending.size();
+}
+
+
+/**
+ * @brief Moves a number along by a byte, -1 being the end of the text
+ *
+ * @return Whether @p c was consumed, otherwise it must be processed again in the new state
+ */
+bool normalizer::process_byte(int c)
+{
+    switch (m_state)
+    {
+    case DIGITS:
+        if (is_digit(c))
+        {
+            if (m_separator != 0u && m_groupLength == 3u)
+            {
+                // Too many digits for a group, the separator was a mere space
+                roll_back();
+                return false;
+            }
+            m_pending += char(c);
+            ++m_groupLength;
+            if (m_separator == 0u)
+                m_committed = m_pending.size();
+            return true;
+        }
+
+        if (m_separator != 0u)
+        {
+            if (m_groupLength != 3u)
+            {
+                roll_back();
+                return false;
+            }
+            m_committed = m_pending.size();
+        }
+
+        if (m_groupLength <= 3u && (c == ' ' || c == 0xC2 || c == 0xE2) && (m_separator == 0u || c == m_separator))
+        {
+            m_separator   = static_cast<unsigned char>(c);
+            m_groupLength = 0;
+            m_pending    += char(c);
+            if (separator_length(m_separator) != 1u)
+                m_state = SEPARATOR;
+            return true;
+        }
+
+        if (c >= 0 && !m_negative)
+        {
+            const char byte = char(c);
+            if (find_ordinal_abbreviation(&byte, 1, true))
+            {
+                m_pending += byte;
+                m_state    = SUFFIX;
+                return true;
+            }
+        }
+
+        end_number(m_options);
+        return false;
+
+    case SEPARATOR:
+    {
+        const char*  separator = (m_separator == 0xC2) ? "\xC2\xA0" : "\xE2\x80\xAF";
+        const size_t i         = m_pending.size() - m_committed;
+        if (c != static_cast<unsigned char>(separator[i]))
+        {
+            roll_back();
+            return false;
+        }
+        m_pending += char(c);
+        if (i + 1u == separator_length(m_separator))
+            m_state = DIGITS;
+        return true;
+    }
+
+    default: // SUFFIX
+    {
+        if (c >= 0)
+        {
+            m_pending += char(c);
+            if (find_ordinal_abbreviation(m_pending.data() + m_committed, m_pending.size() - m_committed, true))
+                return true;
+            m_pending.resize(m_pending.size() - 1u);
+        }
+
+        const OrdinalAbbreviation* const abbreviation = find_ordinal_abbreviation(m_pending.data() + m_committed, m_pending.size() - m_committed, false);
+        if (abbreviation && !is_word_byte(c))
+        {
+            const unsigned value = small_value(m_pending.data(), m_pending.data() + m_committed);
+            if (abbreviation->value == 0u && value != 1u)
+            {
+                end_number(m_options | abbreviation->options);
+                return false;
+            }
+            if (abbreviation->value == value)
+            {
+                end_number((m_options & ~FEMININE) | abbreviation->options);
+                return false;
+            }
+        }
+        roll_back();
+        return false;
+    }
+    }
+}
+
+
+/**
+ * @brief Writes the spelling of the number, dropping whatever was held back after it
+ */
+void normalizer::end_number(unsigned options)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < m_committed; ++i)
+        if (m_pending[i] == '-' || is_digit(static_cast<unsigned char>(m_pending[i])))
+            m_pending[length++] = m_pending[i];
+
+    m_spelling.clear();
+    StringSink sink(m_spelling);
+    const std::errc ec = format_decimal(sink, m_pending.data(), m_pending.data() + length, options);
+    assert(ec == std::errc());
+    (void)ec;
+    m_pending.clear();
+    m_state = TEXT;
+    write(m_spelling.data(), m_spelling.size());
+}
+
+
+/**
+ * @brief Ends the number where it was last known to end, then processes again what was held
+ *        back after it
+ */
+void normalizer::roll_back()
+{
+    // At most a separator and two digits, or the beginning of an abbreviation
+    char         rest[8];
+    const size_t length = m_pending.size() - m_committed;
+    assert(length <= sizeof(rest));
+    memcpy(rest, m_pending.data() + m_committed, length);
+    end_number(m_options);
+    process(rest, rest + length);
+}
+
+
+//=================================================================================================
+// Scanning
+
+/**
+ * @brief Deterministic automaton recognizing the words of the word table, one byte at a time
+ *
+ * It is a trie whose transitions go through byte classes, which keeps its table small: only the
+ * bytes found in the words have a class of their own, uppercase letters sharing theirs with the
+ * lowercase ones. States are stored as the offset of their row of transitions, so that moving to
+ * the next state is a mere addition and lookup.
+ */
+struct WordAutomaton
+{
+    std::atomic<bool>     built;
+    uint8_t               classes[256]; ///< The class of each byte, 0 for the bytes no word contains
+    uint8_t               inWord[256];  ///< Whether each byte continues a word, as a letter, a digit or a UTF-8 continuation byte
+    size_t                classCount;
+    std::vector<uint16_t> next;         ///< The next state for each state and class, state 0 being a dead end
+    std::vector<uint8_t>  words;        ///< 1 + the index within the word table of the word each state ends, 0 if none, by row
+};
+
+static const uint16_t AUTOMATON_DEAD = 0;
+
+static WordAutomaton  g_wordAutomaton;
+static std::once_flag g_wordAutomatonFlag;
+
+
+static void build_word_automaton(WordAutomaton& automaton)
+{
+    const WordTable& table = word_table();
+
+    memset(automaton.classes, 0, sizeof(automaton.classes));
+    automaton.classCount = 1;
+    for (size_t i = 0; i < table.textLength; ++i)
+    {
+        uint8_t& byteClass = automaton.classes[static_cast<unsigned char>(table.text[i])];
+        if (byteClass == 0u)
+            byteClass = static_cast<uint8_t>(automaton.classCount++);
+    }
+    for (unsigned c = 'A'; c <= 'Z'; ++c)
+        automaton.classes[c] = automaton.classes[c + 0x20u];
+    for (unsigned c = 0x80; c < 0xA0u; ++c) // The second bytes of "À" to "Þ", which are those of "à" to "þ" minus 0x20
+        if (automaton.classes[c] == 0u)
+            automaton.classes[c] = automaton.classes[c + 0x20u];
+    for (unsigned c = 0; c < 256u; ++c)
+        automaton.inWord[c] = (is_word_byte(int(c)) || (c & 0xC0u) == 0x80u) ? 1u : 0u;
+
+    // State 0 is the dead end, state 1 the root
+    const size_t rowSize = automaton.classCount;
+    automaton.next.assign(2u * rowSize, AUTOMATON_DEAD);
+    automaton.words.assign(2u * rowSize, 0);
+    for (size_t w = 0; w < table.wordCount; ++w)
+    {
+        const Word& word = table.words[w];
+        size_t      row  = rowSize;
+        for (size_t i = 0; i < word.length; ++i)
+        {
+            const size_t transition = row + automaton.classes[static_cast<unsigned char>(table.text[word.offset + i])];
+            if (automaton.next[transition] == AUTOMATON_DEAD)
+            {
+                assert(automaton.next.size() + rowSize <= UINT16_MAX);
+                automaton.next[transition] = static_cast<uint16_t>(automaton.next.size());
+                automaton.next.resize(automaton.next.size() + rowSize, AUTOMATON_DEAD);
+                automaton.words.resize(automaton.next.size(), 0);
+            }
+            row = automaton.next[transition];
+        }
+        automaton.words[row] = static_cast<uint8_t>(w + 1u);
+    }
+
+    automaton.built.store(true, std::memory_order_release);
+}
+
+
+static const WordAutomaton& word_automaton()
+{
+    if (!g_wordAutomaton.built.load(std::memory_order_acquire))
+        std::call_once(g_wordAutomatonFlag, build_word_automaton, std::ref(g_wordAutomaton));
+    return g_wordAutomaton;
+}
+
+
+struct internal::ScannerState
+{
+    const WordTable&     table;
+    const WordAutomaton& automaton;
+    found_function       found;
+    void*                context;
+    uint64_t             offset;     ///< The offset of the next chunk within the text
+    uint64_t             wordStart;  ///< Where the word being read starts
+    uint16_t             state;      ///< The state of the automaton, `AUTOMATON_DEAD` outside of words
+    bool                 inWord;
+    bool                 adjacent;   ///< Whether the next word directly follows the number, after a single space or hyphen
+    bool                 active;     ///< Whether the parser has read any word
+    bool                 hasNumber;  ///< Whether `number` holds a number
+    NumberParser         parser;
+    spelled_number       number;     ///< The number read so far, which ends with the last word of the number itself
+
+    ScannerState(found_function found_, void* context_):
+        table(word_table()),
+        automaton(word_automaton()),
+        found(found_),
+        context(context_)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        offset    = 0;
+        wordStart = 0;
+        state     = AUTOMATON_DEAD;
+        inWord    = false;
+        adjacent  = false;
+        active    = false;
+        hasNumber = false;
+    }
+
+    /**
+     * @brief Reports the number read so far, and forgets about it
+     */
+    void end_number()
+    {
+        if (hasNumber)
+            found(context, number);
+        hasNumber = false;
+        active    = false;
+    }
+
+    /**
+     * @brief Tries to add a word to the number, reporting the number if it can't be part of it
+     *
+     * A word that ends a number may start the next one, which is the only word ever read twice.
+     */
+    void add_word(const Word* word, uint64_t end)
+    {
+        if (!(word != nullptr && active && adjacent && parser.add(*word)))
+        {
+            end_number();
+            if (word == nullptr)
+                return;
+            parser = NumberParser();
+            number.offset = wordStart;
+            if (!parser.add(*word))
+                return;
+        }
+        active = true;
+
+        // The number only ends after one of its own words, not after "moins" nor "et"
+        if (word->kind != WORD_MINUS && word->kind != WORD_ET)
+        {
+            hasNumber       = true;
+            number.length   = size_t(end - number.offset);
+            number.ec       = parser.overflow ? std::errc::result_out_of_range : std::errc();
+            number.value    = parser.overflow ? 0u : parser.value();
+            number.negative = parser.negative;
+            number.options  = parser.options;
+        }
+    }
+
+    void end_word(uint64_t end)
+    {
+        const uint8_t index = automaton.words[state];
+        add_word((index != 0u) ? &table.words[index - 1u] : nullptr, end);
+        inWord   = false;
+        adjacent = false;
+    }
+
+    void feed(const char* data, size_t size)
+    {
+        const unsigned char* const first   = reinterpret_cast<const unsigned char*>(data);
+        const unsigned char* const last    = first + size;
+        const uint8_t*       const classes = automaton.classes;
+        const uint8_t*       const inWords = automaton.inWord;
+        const uint16_t*      const next    = automaton.next.data();
+        const unsigned char*       cur     = first;
+        while (cur != last)
+        {
+            if (inWord)
+            {
+                // UTF-8 continuation bytes belong to the letter before them. Most words are not
+                // number words, which is known well before their end.
+                uint16_t row = state;
+                while (cur != last && inWords[*cur] && row != AUTOMATON_DEAD)
+                    row = next[row + classes[*cur++]];
+                while (cur != last && inWords[*cur])
+                    ++cur;
+                state = row;
+                if (cur == last)
+                    break;
+
+                end_word(offset + uint64_t(cur - first));
+                adjacent = (*cur == ' ' || *cur == '-');
+                if (!adjacent)
+                    end_number();
+                ++cur;
+            }
+            else if (is_word_byte(*cur))
+            {
+                inWord    = true;
+                wordStart = offset + uint64_t(cur - first);
+                state     = next[automaton.classCount + classes[*cur++]];
+            }
+            else
+            {
+                if (adjacent)
+                {
+                    // A second separator, or anything else between words, ends the number
+                    adjacent = false;
+                    end_number();
+                }
+                ++cur;
+            }
+        }
+        offset += size;
+    }
+};
+
+
+scanner::scanner(found_function found, void* context):
+    m_state(new internal::ScannerState(found, context))
+{
+}
+
+
+scanner::~scanner()
+{
+}
+
+
+void scanner::feed(const char* data, size_t size)
+{
+    m_state->feed(data, size);
+}
+
+
+void scanner::finish()
+{
+    if (m_state->inWord)
+        m_state->end_word(m_state->offset);
+    m_state->end_number();
+    m_state->reset();
+}
+
+
+//=================================================================================================
+// Validation
+
+/**
+ * @brief Sink that compares the spelling with a candidate as it goes, ignoring everything after
+ *        the first difference
+ */
+struct MatchingSink
+{
+    const char* cur;
+    const char* last;
+    bool        mismatch;
+
+    MatchingSink(const char* first, const char* last_): cur(first), last(last_), mismatch(false) {}
+
+    void append(const char* str, size_t length)
+    {
+        if (mismatch || size_t(last - cur) < length || memcmp(cur, str, length) != 0)
+            mismatch = true;
+        else
+            cur += length;
+    }
+
+    void append(WordRef word) {append(Words::pool + word.offset, word.length);}
+};
+
+
+template<typename Integer>
+static bool matches_impl(Integer value, unsigned options, const char* first, const char* last)
+{
+    const internal::Profile& profile = *internal::resolve_profile(options);
+    MatchingSink sink(first, last);
+    format(sink, value, profile.options, ProfileEngine(profile));
+    return !sink.mismatch && sink.cur == last;
+}
+
+
+/**
+ * @brief Sink that compares the spelling with a candidate word by word, recording the word
+ *        where they differ and the one before it
+ */
+struct DiagnosingSink
+{
+    const char* first;
+    const char* cur;
+    const char* last;
+    bool        diverged;
+    size_t      offset;        ///< Where the candidate differs, if `diverged`
+    token       expected;      ///< The token the candidate differs from, if `diverged`
+    const char* expectedStart; ///< Where `expected` would start in the candidate
+    token       previous;      ///< The last token the candidate matched, if `hasPrevious`
+    const char* previousStart;
+    bool        hasPrevious;
+
+    DiagnosingSink(const char* first_, const char* last_):
+        first(first_), cur(first_), last(last_), diverged(false), offset(0), expected(token::UN),
+        expectedStart(first_), previous(token::UN), previousStart(first_), hasPrevious(false) {}
+
+    void append(WordRef word)
+    {
+        if (diverged)
+            return;
+        const char* const text = Words::pool + word.offset;
+        size_t i = 0;
+        while (i < word.length && cur + i != last && cur[i] == text[i])
+            ++i;
+        if (i == word.length)
+        {
+            previous      = static_cast<token>(word.id);
+            previousStart = cur;
+            hasPrevious   = true;
+            cur          += i;
+        }
+        else
+        {
+            diverged      = true;
+            offset        = size_t(cur - first) + i;
+            expected      = static_cast<token>(word.id);
+            expectedStart = cur;
+        }
+    }
+};
+
+
+/**
+ * @brief Tells whether @p str starts with the text of @p t
+ */
+static bool starts_with(const char* str, const char* last, token t)
+{
+    const WordRef word = Words::tokens[size_t(t)];
+    return size_t(last - str) >= word.length && memcmp(str, Words::pool + word.offset, word.length) == 0;
+}
+
+
+static bool starts_with(const char* str, const char* last, const char* prefix)
+{
+    const size_t length = strlen(prefix);
+    return size_t(last - str) >= length && memcmp(str, prefix, length) == 0;
+}
+
+
+/**
+ * @brief Tells whether @p str starts with the word of the other gender than @p t, if it has one
+ */
+static bool starts_with_other_gender(const char* str, const char* last, token t)
+{
+    token other;
+    switch (t)
+    {
+        case token::UN:       other = token::UNE;      break;
+        case token::UNE:      other = token::UN;       break;
+        case token::PREMIER:  other = token::PREMIERE; break;
+        case token::PREMIERE: other = token::PREMIER;  break;
+        case token::SECOND:   other = token::SECONDE;  break;
+        case token::SECONDE:  other = token::SECOND;   break;
+        default:              return false;
+    }
+    if (!starts_with(str, last, other))
+        return false;
+    str += Words::tokens[size_t(other)].length;
+    return str == last || *str == ' ' || *str == '-';
+}
+
+
+/**
+ * @brief Works out why the candidate differs from the spelling, from where the sink stopped
+ */
+static match_result diagnose(const DiagnosingSink& sink)
+{
+    const char* const last   = sink.last;
+    const size_t      offset = sink.diverged ? sink.offset : size_t(sink.cur - sink.first);
+    const char* const rest   = sink.first + offset;
+    if (!sink.diverged)
+    {
+        if (rest == last)
+            return match_result{offset, mismatch::none};
+        if (sink.hasPrevious && starts_with_other_gender(sink.previousStart, last, sink.previous))
+            return match_result{offset, mismatch::gender};
+        if (*rest == 's' && (rest + 1 == last || rest[1] == ' ' || rest[1] == '-'))
+            return match_result{offset, mismatch::extra_plural};
+        return match_result{offset, mismatch::trailing};
+    }
+
+    if (starts_with_other_gender(sink.expectedStart, last, sink.expected)
+     || (sink.hasPrevious && starts_with_other_gender(sink.previousStart, last, sink.previous)))
+        return match_result{offset, mismatch::gender};
+
+    const token expected = sink.expected;
+    if (expected == token::PLURAL_S)
+        return match_result{offset, mismatch::missing_plural};
+
+    const bool isJoiner = (expected == token::JOIN_HYPHEN || expected == token::JOIN_SPACE || expected == token::JOIN_ET);
+    if (isJoiner && rest != last && *rest == 's' && (rest + 1 == last || rest[1] == ' ' || rest[1] == '-'))
+        return match_result{offset, mismatch::extra_plural};
+    if (isJoiner)
+    {
+        // Joiners are compared from their start, as " et " and " " share their first byte
+        const char* const joiner = sink.expectedStart;
+        const bool        hasEt  = starts_with(joiner, last, " et ") || starts_with(joiner, last, "-et-");
+        if (expected == token::JOIN_ET)
+        {
+            if (starts_with(joiner, last, "-et-"))
+                return match_result{offset, mismatch::joiner};
+            if (joiner != last && (*joiner == ' ' || *joiner == '-'))
+                return match_result{offset, mismatch::et};
+        }
+        else if (hasEt)
+            return match_result{offset, mismatch::et};
+        else if (joiner != last && (*joiner == ' ' || *joiner == '-'))
+            return match_result{offset, mismatch::joiner};
+    }
+
+    return match_result{offset, (rest == last) ? mismatch::truncated : mismatch::other};
+}
+
+
+template<typename Integer>
+static match_result check_spelling_impl(Integer value, unsigned options, const char* first, const char* last)
+{
+    DiagnosingSink sink(first, last);
+    format(sink, value, options, internal::RuleEngine());
+    return diagnose(sink);
+}
+
+
+bool internal::matches(intmax_t value, unsigned options, const char* first, const char* last)
+{
+    return matches_impl(value, options, first, last);
+}
+
+
+bool internal::matches(uintmax_t value, unsigned options, const char* first, const char* last)
+{
+    return matches_impl(value, options, first, last);
+}
+
+
+match_result internal::check_spelling(intmax_t value, unsigned options, const char* first, const char* last)
+{
+    return check_spelling_impl(value, options, first, last);
+}
+
+
+match_result internal::check_spelling(uintmax_t value, unsigned options, const char* first, const char* last)
+{
+    return check_spelling_impl(value, options, first, last);
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+bool internal::matches(int128_t value, unsigned options, const char* first, const char* last)
+{
+    return matches_impl(value, options, first, last);
+}
+
+
+bool internal::matches(uint128_t value, unsigned options, const char* first, const char* last)
+{
+    return matches_impl(value, options, first, last);
+}
+
+
+match_result internal::check_spelling(int128_t value, unsigned options, const char* first, const char* last)
+{
+    return check_spelling_impl(value, options, first, last);
+}
+
+
+match_result internal::check_spelling(uint128_t value, unsigned options, const char* first, const char* last)
+{
+    return check_spelling_impl(value, options, first, last);
+}
+#endif
+
+
+//=================================================================================================
+// Autocompletion
+
+/**
+ * @brief The groups of [1;999] of a group table, sorted by spelling
+ */
+struct SortedGroups
+{
+    const GroupTable*     table;
+    uint16_t              order[999];
+    std::vector<uint16_t> firstWords; ///< Where the runs of groups starting with the same word start within `order`, then 999
+    uint16_t              buckets[257]; ///< Where the groups starting with each byte start within `order`, then 999
+
+    const char* text(unsigned group) const   {return table->bytes.data() + table->offsets[group];}
+    size_t      length(unsigned group) const {return size_t(table->offsets[group+1] - table->offsets[group]);}
+
+    /** @brief Finds the first group whose spelling isn't less than [@p first; @p first+@p length) */
+    const uint16_t* lower_bound(const char* first, size_t length) const
+    {
+        if (length == 0u)
+            return order;
+        const unsigned char c = static_cast<unsigned char>(*first);
+        return std::lower_bound(order + buckets[c], order + buckets[c+1], 0, [&](uint16_t group, int)
+        {
+            const size_t groupLength = this->length(group);
+            const int    diff        = memcmp(text(group), first, std::min(groupLength, length));
+            return (diff < 0) || (diff == 0 && groupLength < length);
+        });
+    }
+};
+
+
+static void sort_groups(SortedGroups& sorted, const GroupTable& table)
+{
+    sorted.table = &table;
+    for (unsigned group = 1; group < 1000u; ++group)
+        sorted.order[group-1] = static_cast<uint16_t>(group);
+    std::sort(sorted.order, sorted.order + 999, [&](uint16_t a, uint16_t b)
+    {
+        const size_t lengthA = sorted.length(a);
+        const size_t lengthB = sorted.length(b);
+        const int    diff    = memcmp(sorted.text(a), sorted.text(b), std::min(lengthA, lengthB));
+        return (diff < 0) || (diff == 0 && lengthA < lengthB);
+    });
+
+    size_t previousLength = 0;
+    for (uint16_t i = 0; i < 999u; ++i)
+    {
+        const char* text   = sorted.text(sorted.order[i]);
+        size_t      length = 0;
+        while (length < sorted.length(sorted.order[i]) && text[length] != ' ' && text[length] != '-')
+            ++length;
+        if (i == 0u || length != previousLength || memcmp(text, sorted.text(sorted.order[i-1]), length) != 0)
+            sorted.firstWords.push_back(i);
+        previousLength = length;
+    }
+    sorted.firstWords.push_back(999);
+
+    uint16_t i = 0;
+    for (unsigned c = 0; c < 256u; ++c)
+    {
+        sorted.buckets[c] = i;
+        while (i < 999u && static_cast<unsigned char>(*sorted.text(sorted.order[i])) == c)
+            ++i;
+    }
+    sorted.buckets[256] = 999;
+}
+
+
+/**
+ * @brief What surrounds the groups of a level, which only depends on the options
+ */
+struct CompletionTexts
+{
+    std::string terminalTail; ///< After the groups from 2 on that end the number: " millions", " millionième"
+    std::string innerTail;    ///< After the groups from 2 on that lower groups follow: " millions "
+    std::string terminalOne;  ///< Group 1 when it ends the number: "mille", "un million", "millionième"
+    std::string innerOne;     ///< Group 1 when lower groups follow: "mille ", "un million "
+};
+
+
+static const size_t MAX_LEVELS = 8;
+
+struct internal::CompletionIndex
+{
+    unsigned        options;           ///< As passed to the engines
+    size_t          levels;            ///< The number of base-1000 groups of the largest value
+    uintmax_t       scales[MAX_LEVELS];
+    SortedGroups    groups;            ///< The lowest group
+    SortedGroups    nouns;             ///< The multipliers of million, milliard, ...
+    SortedGroups    adjectives;        ///< The multipliers of mille, cent and the ordinal nouns
+    CompletionTexts texts[MAX_LEVELS];
+    CompletionTexts hundreds[9];       ///< "onze cent" to "dix-neuf cent", for `CENT_1100_1999`
+};
+
+
+/**
+ * @brief The values a level may take below its base, as a bit per group
+ */
+struct CompletionLevel
+{
+    uintmax_t base;
+    uintmax_t scale;
+    unsigned  minGroup;
+    unsigned  maxGroup;
+    uint32_t  terminals[32]; ///< The groups that end the number
+    uint32_t  inners[32];    ///< The groups that are followed by lower ones
+
+    static void set(uint32_t* bits, unsigned group) {bits[group / 32u] |= uint32_t(1) << (group % 32u);}
+};
+
+
+/**
+ * @brief The groups of a table that the prefix starts with, or that start with the prefix
+ */
+struct GroupMatches
+{
+    /** @brief Groups, contiguous in sorted order, that complete the last word of the prefix alike */
+    struct Run
+    {
+        const uint16_t* first;
+        const uint16_t* last;
+    };
+
+    const SortedGroups* sorted;
+    size_t              runCount;
+    Run                 runs[64];  ///< The groups the prefix ends within, a few dozen words completing it at most
+    size_t              count;
+    uint16_t            groups[8]; ///< The groups the prefix goes past, as they are followed by a space
+    const char*         ends[8];   ///< Where each of these groups ends within the prefix
+};
+
+
+/**
+ * @brief Looks a prefix up, matching it group after group against the tables of an index
+ *
+ * A group either ends the number or is followed by a space and lower groups, in which case the
+ * spellings of the lower groups are matched against what follows, with a base raised accordingly.
+ */
+struct Completer
+{
+    const internal::CompletionIndex& index;
+    completions&                     result;
+    const char*                      wordStart; ///< Where the last word of the prefix starts
+    const char*                      end;
+
+    Completer(const internal::CompletionIndex& index_, completions& result_, const char* first, const char* last):
+        index(index_),
+        result(result_),
+        wordStart(last),
+        end(last)
+    {
+        while (wordStart != first && wordStart[-1] != ' ' && wordStart[-1] != '-')
+            --wordStart;
+    }
+
+    void add_range(uintmax_t first, uintmax_t last)
+    {
+        if (!result.values.empty() && result.values.back().last != UINTMAX_MAX && result.values.back().last + 1u == first)
+            result.values.back().last = last;
+        else
+            result.values.push_back(value_range{first, last});
+    }
+
+    /** @brief Where the word of [@p text; @p text+@p length) that completes the last word of the prefix ends */
+    size_t word_end(const char* text, size_t length, const char* start) const
+    {
+        size_t wordEnd = size_t(end - start);
+        while (wordEnd < length && text[wordEnd] != ' ' && text[wordEnd] != '-')
+            ++wordEnd;
+        return wordEnd;
+    }
+
+    /**
+     * @brief Adds the word of [@p text; @p text+@p length) that completes the last word of the prefix,
+     *        @p text being matched against the prefix from @p start
+     */
+    void add_word(const char* text, size_t length, const char* start)
+    {
+        const size_t wordBegin = size_t(wordStart - start);
+        const size_t wordEnd   = word_end(text, length, start);
+
+        // There are a few dozen words at most, and they come up again level after level
+        const size_t wordLength = wordEnd - wordBegin;
+        for (size_t i = result.words.size(); i-- != 0u; )
+            if (result.words[i].size() == wordLength && memcmp(result.words[i].data(), text + wordBegin, wordLength) == 0)
+                return;
+        result.words.push_back(std::string(text + wordBegin, wordLength));
+    }
+
+    /**
+     * @brief Matches the prefix from @p first against a spelling, going on with the lower groups
+     *        at @p nextBase if it is followed by some
+     *
+     * @return Whether the prefix ends within the spelling
+     */
+    bool follow(const char* first, const char* text, size_t length, bool inner, uintmax_t nextBase, size_t nextLevels, unsigned nextMaxGroup)
+    {
+        // Where the lower groups would start, they tell the next words better than the spelling
+        const size_t remaining = size_t(end - first);
+        if (remaining < length || (remaining == length && !inner))
+        {
+            if (memcmp(first, text, remaining) != 0)
+                return false;
+            add_word(text, length, first);
+            return true;
+        }
+        if (inner && memcmp(first, text, length) == 0)
+            complete(first + length, nextBase, nextLevels, nextMaxGroup);
+        return false;
+    }
+
+    /**
+     * @brief Matches the prefix from @p first against the groups of @p sorted, which is the same
+     *        at every level
+     */
+    void match_groups(const char* first, const SortedGroups& sorted, GroupMatches& matches) const
+    {
+        matches.sorted   = &sorted;
+        matches.runCount = 0;
+        matches.count    = 0;
+
+        // The groups the prefix ends within, the end of each run being searched for once
+        const size_t          remaining = size_t(end - first);
+        const uint16_t* const orderEnd  = sorted.order + 999;
+        for (const uint16_t* it = (remaining != 0u) ? sorted.lower_bound(first, remaining) : orderEnd; it != orderEnd; )
+        {
+            const char*  text   = sorted.text(*it);
+            const size_t length = sorted.length(*it);
+            if (length < remaining || memcmp(text, first, remaining) != 0)
+                break;
+            assert(matches.runCount < sizeof(matches.runs) / sizeof(matches.runs[0]));
+            const size_t       wordEnd = word_end(text, length, first);
+            GroupMatches::Run& run     = matches.runs[matches.runCount++];
+            run.first = it;
+            run.last  = std::partition_point(it, orderEnd, [&](uint16_t other)
+            {
+                const size_t otherLength = sorted.length(other);
+                const char*  otherText   = sorted.text(other);
+                return otherLength >= wordEnd && memcmp(otherText, text, wordEnd) == 0
+                    && (otherLength == wordEnd || otherText[wordEnd] == ' ' || otherText[wordEnd] == '-');
+            });
+            it = run.last;
+        }
+
+        // The groups the prefix goes past
+        for (const char* space = first; (space = static_cast<const char*>(memchr(space, ' ', size_t(end - space)))) != nullptr; ++space)
+        {
+            // Once no group starts like the prefix, longer prefixes can't be groups either
+            const size_t    length = size_t(space - first);
+            const uint16_t* it     = sorted.lower_bound(first, length);
+            if (it == sorted.order + 999 || sorted.length(*it) < length || memcmp(sorted.text(*it), first, length) != 0)
+                break;
+            if (sorted.length(*it) != length)
+                continue;
+            assert(matches.count < sizeof(matches.groups) / sizeof(matches.groups[0]));
+            matches.groups[matches.count] = *it;
+            matches.ends[matches.count]   = space;
+            ++matches.count;
+        }
+    }
+
+    /**
+     * @brief Matches the prefix from @p first against the spellings of a level, made of one of the
+     *        groups of @p matches followed by @p tail
+     */
+    void scan(const char* first, CompletionLevel& level, size_t levelIndex, const GroupMatches& matches, const char* tail, size_t tailLength, bool inner)
+    {
+        const SortedGroups& sorted = *matches.sorted;
+        uint32_t*           bits   = inner ? level.inners : level.terminals;
+
+        // Nothing to match yet, as at the start of the lower groups: all of them follow
+        if (first == end)
+        {
+            for (unsigned group = level.minGroup; group <= level.maxGroup; ++group)
+                CompletionLevel::set(bits, group);
+            for (size_t w = 0; w + 1u < sorted.firstWords.size(); ++w)
+            {
+                for (size_t i = sorted.firstWords[w]; i < sorted.firstWords[w+1]; ++i)
+                {
+                    const unsigned group = sorted.order[i];
+                    if (group >= level.minGroup && group <= level.maxGroup)
+                    {
+                        add_word(sorted.text(group), sorted.length(group), first);
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+
+        // The prefix ends within the group
+        for (size_t r = 0; r < matches.runCount; ++r)
+        {
+            const GroupMatches::Run& run   = matches.runs[r];
+            bool                     found = false;
+            for (const uint16_t* it = run.first; it != run.last; ++it)
+            {
+                if (*it >= level.minGroup && *it <= level.maxGroup)
+                {
+                    CompletionLevel::set(bits, *it);
+                    found = true;
+                }
+            }
+            if (found)
+                add_word(sorted.text(*run.first), sorted.length(*run.first), first);
+        }
+
+        // The prefix goes past the group, which ends at a space
+        if (tailLength == 0u)
+            return;
+        for (size_t i = 0; i < matches.count; ++i)
+        {
+            const unsigned group = matches.groups[i];
+            if (group < level.minGroup || group > level.maxGroup)
+                continue;
+            if (follow(matches.ends[i], tail, tailLength, inner, level.base + group * level.scale, levelIndex, 999))
+                CompletionLevel::set(bits, group);
+        }
+    }
+
+    /** @brief Turns the groups found for a level into ranges of values */
+    void add_ranges(const CompletionLevel& level)
+    {
+        for (unsigned i = 0; i < 32u; ++i)
+        {
+            const uint32_t mask = level.terminals[i] | level.inners[i];
+            if (mask == 0u)
+                continue;
+
+            // 32 groups with all their lower groups make a single range
+            const uintmax_t firstValue = level.base + 32u * i * level.scale;
+            if ((level.terminals[i] & level.inners[i]) == UINT32_MAX && (UINTMAX_MAX - firstValue) / level.scale >= 32u)
+            {
+                add_range(firstValue, firstValue + (32u * level.scale - 1u));
+                continue;
+            }
+
+            for (unsigned bit = 0; bit < 32u; ++bit)
+            {
+                if (!(mask & (uint32_t(1) << bit)))
+                    continue;
+                const uintmax_t value = level.base + (32u * i + bit) * level.scale;
+                if (level.terminals[i] & (uint32_t(1) << bit))
+                    add_range(value, value);
+                if ((level.inners[i] & (uint32_t(1) << bit)) && value != UINTMAX_MAX)
+                    add_range(value + 1u, value + std::min(UINTMAX_MAX - value, level.scale - 1u));
+            }
+        }
+    }
+
+    void complete(const char* first, uintmax_t base, size_t levels, unsigned maxGroup);
+};
+
+
+void Completer::complete(const char* first, uintmax_t base, size_t levels, unsigned maxGroup)
+{
+    const unsigned options = index.options;
+    const bool     ordinal = (options & ORDINAL) != 0u;
+
+    // The numbers that aren't spelled out from groups
+    if (base == 0u)
+    {
+        const WordRef zero = ordinal ? internal::g_zeroieme : internal::g_zero;
+        if (follow(first, Words::pool + zero.offset, zero.length, false, 0, 0, 0))
+            add_range(0, 0);
+        if (ordinal)
+        {
+            const WordRef one = Words::first[options & FEMININE];
+            if (follow(first, Words::pool + one.offset, one.length, false, 0, 0, 0))
+                add_range(1, 1);
+        }
+        if (ordinal && (options & SECOND))
+        {
+            const WordRef two = Words::second[options & FEMININE];
+            if (follow(first, Words::pool + two.offset, two.length, false, 0, 0, 0))
+                add_range(2, 2);
+        }
+    }
+
+    // The groups are matched once, the levels only differing by what follows them
+    GroupMatches groups;
+    GroupMatches nouns;
+    GroupMatches adjectives;
+    match_groups(first, index.groups, groups);
+    if (levels > 1u)
+        match_groups(first, index.adjectives, adjectives);
+    if (levels > 2u)
+        match_groups(first, index.nouns, nouns);
+
+    CompletionLevel level;
+    level.base = base;
+    for (size_t k = levels; k-- != 0u; )
+    {
+        level.scale    = index.scales[k];
+        level.maxGroup = unsigned(std::min<uintmax_t>((UINTMAX_MAX - base) / level.scale, (k == 0u) ? maxGroup : 999u));
+        if (level.maxGroup == 0u)
+            continue;
+        memset(level.terminals, 0, sizeof(level.terminals));
+        memset(level.inners,    0, sizeof(level.inners));
+
+        if (k == 0u)
+        {
+            // "premier" and "second" stand for the whole number
+            level.minGroup = (base != 0u || !ordinal) ? 1u : (options & SECOND) ? 3u : 2u;
+            scan(first, level, k, groups, nullptr, 0, false);
+            add_ranges(level);
+            continue;
+        }
+
+        // Groups from 2 on: "deux mille", "deux millions", "deux millionième"
+        const CompletionTexts& texts = index.texts[k];
+        level.minGroup = 2;
+        scan(first, level, k, (k == 1u || ordinal) ? adjectives : nouns, texts.terminalTail.data(), texts.terminalTail.size(), false);
+        scan(first, level, k, (k == 1u)            ? adjectives : nouns, texts.innerTail.data(),    texts.innerTail.size(),    true);
+
+        // Group 1: "mille", "un million", "millionième"
+        const bool cent = (k == 1u) && (options & CENT_1100_1999);
+        if (follow(first, texts.terminalOne.data(), texts.terminalOne.size(), false, 0, 0, 0))
+            CompletionLevel::set(level.terminals, 1);
+        if (follow(first, texts.innerOne.data(), texts.innerOne.size(), true, base + level.scale, k, cent ? 99u : 999u))
+        {
+            if (cent)
+                add_range(base + 1001u, base + 1099u);
+            else
+                CompletionLevel::set(level.inners, 1);
+        }
+        add_ranges(level);
+
+        // [1100; 1999] as "onze cent", ..., "dix-neuf cent"
+        if (cent)
+        {
+            for (unsigned hundreds = 11; hundreds < 20u; ++hundreds)
+            {
+                const uintmax_t value = base + 100u * hundreds;
+                if (value > UINTMAX_MAX - 99u)
+                    break;
+                const CompletionTexts& spellings = index.hundreds[hundreds - 11u];
+                if (follow(first, spellings.terminalOne.data(), spellings.terminalOne.size(), false, 0, 0, 0))
+                    add_range(value, value);
+                if (follow(first, spellings.innerOne.data(), spellings.innerOne.size(), true, value, 1, 99))
+                    add_range(value + 1u, value + 99u);
+            }
+        }
+    }
+}
+
+
+completion_index::completion_index(unsigned options):
+    m_index(new internal::CompletionIndex)
+{
+    const internal::Profile&   profile = *internal::resolve_profile(options & ~ORDINAL_SUFFIX);
+    internal::CompletionIndex& index   = *m_index;
+    index.options = internal::number_options(profile.options);
+    const bool ordinal = (index.options & ORDINAL) != 0u;
+
+    index.levels    = 1;
+    index.scales[0] = 1;
+    while (UINTMAX_MAX / index.scales[index.levels-1] >= 1000u)
+    {
+        assert(index.levels < MAX_LEVELS);
+        index.scales[index.levels] = index.scales[index.levels-1] * 1000u;
+        ++index.levels;
+    }
+    sort_groups(index.groups,     *profile.groups);
+    sort_groups(index.nouns,      *profile.nounMultipliers);
+    sort_groups(index.adjectives, *profile.adjectiveMultipliers);
+
+    // What surrounds the groups, as format_groups() puts it
+    for (size_t k = 1; k < index.levels; ++k)
+    {
+        CompletionTexts& texts = index.texts[k];
+        const WordRef    scale = Words::numerals[k].cardinal;
+        StringSink       terminalTail(texts.terminalTail);
+        StringSink       innerTail(texts.innerTail);
+        StringSink       terminalOne(texts.terminalOne);
+        StringSink       innerOne(texts.innerOne);
+        terminalTail.append(internal::g_space);
+        innerTail.append(internal::g_space);
+        if (k == 1u)
+        {
+            // "mille" is an invariable adjective, without "un"
+            terminalTail.append(ordinal ? internal::g_millieme : scale);
+            terminalOne.append(ordinal ? internal::g_millieme : scale);
+        }
+        else
+        {
+            terminalTail.append(scale);
+            terminalTail.append(ordinal ? internal::g_ordinalEnding : internal::g_plural);
+            if (!ordinal)
+            {
+                append_group(terminalOne, *profile.nounMultipliers, 1);
+                terminalOne.append(internal::g_space);
+            }
+            terminalOne.append(scale);
+            if (ordinal)
+                terminalOne.append(internal::g_ordinalEnding);
+            append_group(innerOne, *profile.nounMultipliers, 1);
+            innerOne.append(internal::g_space);
+        }
+        innerTail.append(scale);
+        innerOne.append(scale);
+        if (k != 1u)
+            innerTail.append(internal::g_plural);
+        innerTail.append(internal::g_space);
+        innerOne.append(internal::g_space);
+    }
+
+    for (unsigned hundreds = 11; hundreds < 20u; ++hundreds)
+    {
+        CompletionTexts& spellings = index.hundreds[hundreds - 11u];
+        StringSink       terminal(spellings.terminalOne);
+        append_group(terminal, *profile.adjectiveMultipliers, hundreds);
+        terminal.append(internal::g_space);
+        terminal.append(Words::numerals[0].cardinal);
+        spellings.innerOne = spellings.terminalOne + ' ';
+        if (ordinal)
+            terminal.append(internal::g_ordinalEnding);
+        else if (index.options & PLURAL_ALLOWED)
+            terminal.append(internal::g_plural);
+    }
+}
+
+
+completion_index::~completion_index()
+{
+}
+
+
+void completion_index::lookup(const char* first, const char* last, completions& result) const
+{
+    result.values.clear();
+    result.words.clear();
+    Completer completer(*m_index, result, first, last);
+    completer.complete(first, 0, m_index->levels, 999);
+
+    // The levels and their lower groups were visited in no particular order
+    std::vector<value_range>& values = result.values;
+    std::sort(values.begin(), values.end(), [](const value_range& a, const value_range& b) {return a.first < b.first;});
+    size_t count = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (count != 0u && values[count-1].last != UINTMAX_MAX && values[count-1].last + 1u >= values[i].first)
+            values[count-1].last = std::max(values[count-1].last, values[i].last);
+        else
+            values[count++] = values[i];
+    }
+    values.resize(count);
+
+    std::sort(result.words.begin(), result.words.end());
+    result.words.erase(std::unique(result.words.begin(), result.words.end()), result.words.end());
+}
+
+
+//=================================================================================================
+// Collation
+
+static const unsigned SORT_KEY_WEIGHTS = 12;   ///< 5 bits each
+static const unsigned MAX_PIECE_COUNT  = 128;
+
+/**
+ * @brief Base letters of U+00C0 to U+00FF, indexed by the second byte of their UTF-8 sequence
+ *
+ * Ligatures and the letters with no base letter are folded to the closest one, while × and ÷
+ * weigh as separators.
+ */
+static const char g_foldedLatin1[] = "aaaaaaaceeeeiiiidnooooo ouuuuyts"
+                                     "aaaaaaaceeeeiiiidnooooo ouuuuyty";
+
+
+/**
+ * @brief Turns the bytes of a spelling into collation weights
+ *
+ * The weights are 0 for the end of the spelling, 1 for separators and 2 to 27 for letters, case
+ * and accents being ignored.
+ */
+struct WeightDecoder
+{
+    bool lead; ///< Whether the previous byte starts a 2-byte Latin-1 letter
+
+    WeightDecoder(): lead(false) {}
+
+    /**
+     * @brief Feeds a byte, returning whether it completes a character whose weight is @p weight
+     */
+    bool decode(unsigned char c, unsigned& weight)
+    {
+        if (lead)
+        {
+            lead = false;
+            if (0x80 <= c && c <= 0xBF)
+                c = static_cast<unsigned char>(g_foldedLatin1[c - 0x80]);
+        }
+        else if (c == 0xC3)
+        {
+            lead = true;
+            return false;
+        }
+        const unsigned letter = (c | 0x20u) - 'a';
+        weight = (letter < 26) ? 2 + letter : 1;
+        return true;
+    }
+};
+
+
+/**
+ * @brief Sink that records the pieces of a spelling, which point into the persistent word and
+ *        group tables
+ */
+struct PieceSink
+{
+    const char* pieces[MAX_PIECE_COUNT];
+    size_t      lengths[MAX_PIECE_COUNT];
+    size_t      count;
+
+    PieceSink(): count(0) {}
+
+    void append(const char* str, size_t length)
+    {
+        if (length == 0)
+            return;
+        assert(count < MAX_PIECE_COUNT);
+        pieces[count]  = str;
+        lengths[count] = length;
+        ++count;
+    }
+
+    void append(WordRef word) {append(Words::pool + word.offset, word.length);}
+};
+
+
+/**
+ * @brief Sink that compares the spelling with one recorded by a `PieceSink` as it goes, ignoring
+ *        everything after the first difference
+ *
+ * The spellings are compared by collation weights, or by bytes if `bytes` is set.
+ */
+struct CollatingSink
+{
+    const PieceSink& recorded;
+    size_t           piece;
+    size_t           offset;
+    WeightDecoder    recordedDecoder;
+    WeightDecoder    decoder;
+    bool             bytes;
+    int              order;    ///< The order of the recorded spelling relative to this one, once known
+
+    CollatingSink(const PieceSink& recorded_, bool bytes_):
+        recorded(recorded_), piece(0), offset(0), bytes(bytes_), order(0) {}
+
+    bool at_end() const {return piece == recorded.count;}
+
+    unsigned char next_byte()
+    {
+        const unsigned char c = static_cast<unsigned char>(recorded.pieces[piece][offset]);
+        if (++offset == recorded.lengths[piece])
+        {
+            ++piece;
+            offset = 0;
+        }
+        return c;
+    }
+
+    unsigned next_weight()
+    {
+        unsigned weight;
+        while (!at_end())
+        {
+            if (recordedDecoder.decode(next_byte(), weight))
+                return weight;
+        }
+        return 0;
+    }
+
+    void append(const char* str, size_t length)
+    {
+        for (size_t i = 0; i < length && order == 0; ++i)
+        {
+            const unsigned char c = static_cast<unsigned char>(str[i]);
+            unsigned expected, weight;
+            if (bytes)
+            {
+                if (at_end())
+                {
+                    order = -1;
+                    break;
+                }
+                expected = c;
+                weight   = next_byte();
+            }
+            else
+            {
+                if (!decoder.decode(c, expected))
+                    continue;
+                weight = next_weight();
+            }
+            if (weight != expected)
+                order = (weight < expected) ? -1 : 1;
+        }
+    }
+
+    void append(WordRef word) {append(Words::pool + word.offset, word.length);}
+
+    /**
+     * @brief Returns the order once the whole spelling has been appended
+     */
+    int finish()
+    {
+        if (order == 0 && !at_end())
+            order = (bytes || next_weight() != 0) ? 1 : 0;
+        return order;
+    }
+};
+
+
+template<typename Integer>
+static int collate(const PieceSink& recorded, Integer value, const internal::Profile& profile, bool bytes)
+{
+    CollatingSink sink(recorded, bytes);
+    format(sink, value, profile.options, ProfileEngine(profile));
+    return sink.finish();
+}
+
+
+template<typename Integer>
+static int compare_spelled_impl(Integer a, Integer b, unsigned options)
+{
+    if (a == b)
+        return 0;
+    const internal::Profile& profile = *internal::resolve_profile(options);
+    PieceSink recorded;
+    format(recorded, a, profile.options, ProfileEngine(profile));
+    const int order = collate(recorded, b, profile, false);
+    return (order != 0) ? order : collate(recorded, b, profile, true);
+}
+
+
+/**
+ * @brief Sink that packs the collation weights of the first letters into a sort key
+ */
+struct SortKeySink
+{
+    uint64_t      key;
+    unsigned      count;
+    WeightDecoder decoder;
+
+    SortKeySink(): key(0), count(0) {}
+
+    void append(const char* str, size_t length)
+    {
+        for (size_t i = 0; i < length && count < SORT_KEY_WEIGHTS; ++i)
+        {
+            unsigned weight;
+            if (decoder.decode(static_cast<unsigned char>(str[i]), weight))
+            {
+                key = (key << 5) | weight;
+                ++count;
+            }
+        }
+    }
+
+    void append(WordRef word) {append(Words::pool + word.offset, word.length);}
+};
+
+
+template<typename Integer>
+static uint64_t spelled_sort_key_impl(Integer value, unsigned options)
+{
+    const internal::Profile& profile = *internal::resolve_profile(options);
+    SortKeySink sink;
+    format(sink, value, profile.options, ProfileEngine(profile));
+    return sink.key << (5 * (SORT_KEY_WEIGHTS - sink.count)); // Pads with the weight of the end
+}
+
+
+int internal::compare_spelled(intmax_t a, intmax_t b, unsigned options)
+{
+    return compare_spelled_impl(a, b, options);
+}
+
+
+int internal::compare_spelled(uintmax_t a, uintmax_t b, unsigned options)
+{
+    return compare_spelled_impl(a, b, options);
+}
+
+
+uint64_t internal::spelled_sort_key(intmax_t value, unsigned options)
+{
+    return spelled_sort_key_impl(value, options);
+}
+
+
+uint64_t internal::spelled_sort_key(uintmax_t value, unsigned options)
+{
+    return spelled_sort_key_impl(value, options);
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+int internal::compare_spelled(int128_t a, int128_t b, unsigned options)
+{
+    return compare_spelled_impl(a, b, options);
+}
+
+
+int internal::compare_spelled(uint128_t a, uint128_t b, unsigned options)
+{
+    return compare_spelled_impl(a, b, options);
+}
+
+
+uint64_t internal::spelled_sort_key(int128_t value, unsigned options)
+{
+    return spelled_sort_key_impl(value, options);
+}
+
+
+uint64_t internal::spelled_sort_key(uint128_t value, unsigned options)
+{
+    return spelled_sort_key_impl(value, options);
+}
+#endif
+
+
+//=================================================================================================
+// API
+
+std::string internal::spell_out(intmax_t value, unsigned options)
+{
+    return spell_out_impl(*resolve_profile(options), value);
+}
+
+
+std::string internal::spell_out(uintmax_t value, unsigned options)
+{
+    return spell_out_impl(*resolve_profile(options), value);
+}
+
+
+to_words_result internal::to_words(char* first, char* last, intmax_t value, unsigned options)
+{
+    return to_words_impl(*resolve_profile(options), first, last, value);
+}
+
+
+to_words_result internal::to_words(char* first, char* last, uintmax_t value, unsigned options)
+{
+    return to_words_impl(*resolve_profile(options), first, last, value);
+}
+
+
+void internal::append_to(std::string& str, intmax_t value, unsigned options)
+{
+    append_to_impl(*resolve_profile(options), str, value);
+}
+
+
+void internal::append_to(std::string& str, uintmax_t value, unsigned options)
+{
+    append_to_impl(*resolve_profile(options), str, value);
+}
+
+
+size_t internal::spelled_length(intmax_t value, unsigned options)
+{
+    return spelled_length_impl(*resolve_profile(options), value);
+}
+
+
+size_t internal::spelled_length(uintmax_t value, unsigned options)
+{
+    return spelled_length_impl(*resolve_profile(options), value);
+}
+
+
+std::string internal::spell_out_reference(intmax_t value, unsigned options)
+{
+    return spell_out_reference_impl(value, options);
+}
+
+
+std::string internal::spell_out_reference(uintmax_t value, unsigned options)
+{
+    return spell_out_reference_impl(value, options);
+}
+
+
+std::string internal::spell_out(const Profile& profile, intmax_t value)
+{
+    return spell_out_impl(profile, value);
+}
+
+
+std::string internal::spell_out(const Profile& profile, uintmax_t value)
+{
+    return spell_out_impl(profile, value);
+}
+
+
+to_words_result internal::to_words(const Profile& profile, char* first, char* last, intmax_t value)
+{
+    return to_words_impl(profile, first, last, value);
+}
+
+
+to_words_result internal::to_words(const Profile& profile, char* first, char* last, uintmax_t value)
+{
+    return to_words_impl(profile, first, last, value);
+}
+
+
+void internal::append_to(const Profile& profile, std::string& str, intmax_t value)
+{
+    append_to_impl(profile, str, value);
+}
+
+
+void internal::append_to(const Profile& profile, std::string& str, uintmax_t value)
+{
+    append_to_impl(profile, str, value);
+}
+
+
+size_t internal::spelled_length(const Profile& profile, intmax_t value)
+{
+    return spelled_length_impl(profile, value);
+}
+
+
+size_t internal::spelled_length(const Profile& profile, uintmax_t value)
+{
+    return spelled_length_impl(profile, value);
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+std::string internal::spell_out(int128_t value, unsigned options)
+{
+    return spell_out_impl(*resolve_profile(options), value);
+}
+
+
+std::string internal::spell_out(uint128_t value, unsigned options)
+{
+    return spell_out_impl(*resolve_profile(options), value);
+}
+
+
+to_words_result internal::to_words(char* first, char* last, int128_t value, unsigned options)
+{
+    return to_words_impl(*resolve_profile(options), first, last, value);
+}
+
+
+to_words_result internal::to_words(char* first, char* last, uint128_t value, unsigned options)
+{
+    return to_words_impl(*resolve_profile(options), first, last, value);
+}
+
+
+void internal::append_to(std::string& str, int128_t value, unsigned options)
+{
+    append_to_impl(*resolve_profile(options), str, value);
+}
+
+
+void internal::append_to(std::string& str, uint128_t value, unsigned options)
+{
+    append_to_impl(*resolve_profile(options), str, value);
+}
+
+
+size_t internal::spelled_length(int128_t value, unsigned options)
+{
+    return spelled_length_impl(*resolve_profile(options), value);
+}
+
+
+size_t internal::spelled_length(uint128_t value, unsigned options)
+{
+    return spelled_length_impl(*resolve_profile(options), value);
+}
+
+
+std::string internal::spell_out_reference(int128_t value, unsigned options)
+{
+    return spell_out_reference_impl(value, options);
+}
+
+
+std::string internal::spell_out_reference(uint128_t value, unsigned options)
+{
+    return spell_out_reference_impl(value, options);
+}
+
+
+std::string internal::spell_out(const Profile& profile, int128_t value)
+{
+    return spell_out_impl(profile, value);
+}
+
+
+std::string internal::spell_out(const Profile& profile, uint128_t value)
+{
+    return spell_out_impl(profile, value);
+}
+
+
+to_words_result internal::to_words(const Profile& profile, char* first, char* last, int128_t value)
+{
+    return to_words_impl(profile, first, last, value);
+}
+
+
+to_words_result internal::to_words(const Profile& profile, char* first, char* last, uint128_t value)
+{
+    return to_words_impl(profile, first, last, value);
+}
+
+
+void internal::append_to(const Profile& profile, std::string& str, int128_t value)
+{
+    append_to_impl(profile, str, value);
+}
+
+
+void internal::append_to(const Profile& profile, std::string& str, uint128_t value)
+{
+    append_to_impl(profile, str, value);
+}
+
+
+size_t internal::spelled_length(const Profile& profile, int128_t value)
+{
+    return spelled_length_impl(profile, value);
+}
+
+
+size_t internal::spelled_length(const Profile& profile, uint128_t value)
+{
+    return spelled_length_impl(profile, value);
+}
+#endif
+
+
+parse_result internal::parse(const char* first, const char* last)
+{
+    const WordTable& table = word_table();
+
+    parse_result result = {first, std::errc::invalid_argument, 0, false, CARDINAL};
+    NumberParser parser;
+    const char*  cur = first;
+    for (;;)
+    {
+        const char* wordEnd = cur;
+        while (wordEnd != last && *wordEnd != ' ' && *wordEnd != '-')
+            ++wordEnd;
+
+        const Word* word = find_word(table, cur, size_t(wordEnd - cur));
+        if (word == nullptr || !parser.add(*word))
+            break;
+
+        // The number only ends after one of its own words, not after "moins" nor "et"
+        if (word->kind != WORD_MINUS && word->kind != WORD_ET)
+        {
+            result.ptr      = wordEnd;
+            result.ec       = parser.overflow ? std::errc::result_out_of_range : std::errc();
+            result.value    = parser.overflow ? 0u : parser.value();
+            result.negative = parser.negative;
+            result.options  = parser.options;
+        }
+
+        if (wordEnd == last)
+            break;
+        cur = wordEnd + 1;
+    }
+
+    return result;
+}
+
+
+std::errc internal::spell_out_decimal(const char* first, const char* last, unsigned options, write_function write, void* context)
+{
+    WriterSink sink(write, context);
+    return format_decimal(sink, first, last, options);
+}
+
+
+std::errc internal::append_decimal_to(std::string& str, const char* first, const char* last, unsigned options)
+{
+    StringSink sink(str);
+    return format_decimal(sink, first, last, options);
+}
+
+
+to_words_result internal::to_words_fixed(char* first, char* last, intmax_t mantissa, unsigned scale, unsigned options, const char* decimalWord)
+{
+    BufferSink sink(first, last);
+    const std::errc ec = format_fixed(sink, mantissa, scale, options, decimalWord);
+    if (ec != std::errc())
+        return to_words_result{first, ec};
+    if (sink.overflow)
+        return to_words_result{last, std::errc::value_too_large};
+    return to_words_result{sink.cur, std::errc()};
+}
+
+
+std::string internal::spell_out_fixed(intmax_t mantissa, unsigned scale, unsigned options, const char* decimalWord)
+{
+    std::string str;
+    StringSink  sink(str);
+    format_fixed(sink, mantissa, scale, options, decimalWord);
+    return str;
+}
+
+
+to_words_result internal::to_words(char* first, char* last, double value, unsigned options, const char* decimalWord)
+{
+    BufferSink sink(first, last);
+    const std::errc ec = format_double(sink, value, options, decimalWord);
+    if (ec != std::errc())
+        return to_words_result{first, ec};
+    if (sink.overflow)
+        return to_words_result{last, std::errc::value_too_large};
+    return to_words_result{sink.cur, std::errc()};
+}
+
+
+std::string internal::spell_out(double value, unsigned options, const char* decimalWord)
+{
+    std::string str;
+    StringSink  sink(str);
+    format_double(sink, value, options, decimalWord);
+    return str;
+}
+
+
+to_words_result internal::to_words_amount(char* first, char* last, intmax_t amount, const currency& cur, unsigned options)
+{
+    BufferSink sink(first, last);
+    const std::errc ec = format_amount(sink, amount, cur, options);
+    if (ec != std::errc())
+        return to_words_result{first, ec};
+    if (sink.overflow)
+        return to_words_result{last, std::errc::value_too_large};
+    return to_words_result{sink.cur, std::errc()};
+}
+
+
+std::string internal::spell_out_amount(intmax_t amount, const currency& cur, unsigned options)
+{
+    std::string str;
+    StringSink  sink(str);
+    format_amount(sink, amount, cur, options);
+    return str;
+}
+
+
+size_t internal::max_spelled_amount_length(const currency& cur, unsigned options)
+{
+    // Feminine spellings are never shorter than masculine ones
+    const size_t units    = max_spelled_length<intmax_t>(options | FEMININE) + 1 + internal::max_size(strlen(cur.unit),    strlen(cur.units)    + 3); // " d'" or " de "
+    const size_t subunits = max_spelled_length<uint32_t>(options | FEMININE) + 1 + internal::max_size(strlen(cur.subunit), strlen(cur.subunits) + 3);
+    return units + 4 + subunits; // " et "
 }
 
 
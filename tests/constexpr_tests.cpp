@@ -0,0 +1,132 @@
+﻿/*
+ * This software is available under 2 licenses -- choose whichever you prefer.
+ *
+ * -------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2023 Romain BAILLY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * -------------------------------------------------------------------------------
+ *
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * For more information, please refer to <https://unlicense.org/>
+ */
+
+// Compile-time tests: this file compiling is the test
+
+#include <rmgr/nsfr_constexpr.h>
+#include <cstdint>
+#include <cstring>
+
+
+#if RMGR_NSFR_CPLUSPLUS >= 201703L
+
+using namespace rmgr::nsfr;
+
+
+template<size_t N, size_t M>
+constexpr bool equals(const fixed_string<N>& actual, const char (&expected)[M])
+{
+    if (N != M-1)
+        return false;
+    for (size_t i = 0; i < N; ++i)
+        if (actual[i] != expected[i])
+            return false;
+    return actual.c_str()[N] == '\0';
+}
+
+
+//=================================================================================================
+// Cardinals
+
+static_assert(equals(spelled<0>,     "z\xC3\xA9ro"),                 "0");
+static_assert(equals(spelled<1>,     "un"),                          "1");
+static_assert(equals(spelled<1, FEMININE>, "une"),                   "1 (feminine)");
+static_assert(equals(spelled<21>,    "vingt et un"),                 "21");
+static_assert(equals(spelled<-71>,   "moins soixante et onze"),      "-71");
+static_assert(equals(spelled<80>,    "quatre-vingts"),               "80");
+static_assert(equals(spelled<81, FEMININE>, "quatre-vingt-une"),     "81 (feminine)");
+static_assert(equals(spelled<200>,   "deux cents"),                  "200");
+static_assert(equals(spelled<1000000>, "un million"),                "1000000");
+static_assert(equals(spelled<1234, CENT_1100_1999>, "douze cent trente-quatre"),  "1234 (cent)");
+static_assert(equals(spelled<1180, CENT_1100_1999>, "onze cent quatre-vingts"),   "1180 (cent)");
+
+
+//=================================================================================================
+// Ordinals
+
+static_assert(equals(spelled<1, ORDINAL | FEMININE>,  "premi\xC3\xA8re"),            "1st (feminine)");
+static_assert(equals(spelled<80, ORDINAL | FEMININE>, "quatre-vingti\xC3\xA8me"),    "80th (feminine)");
+static_assert(equals(spelled<1000, ORDINAL>,          "milli\xC3\xA8me"),            "1000th");
+static_assert(equals(spelled<2000000u, ORDINAL>,      "deux millioni\xC3\xA8me"),    "2000000th");
+static_assert(equals(spelled<1, ORDINAL_SUFFIX | FEMININE>, "re"),                   "1st (suffix)");
+
+
+//=================================================================================================
+// Variants
+
+static_assert(equals(spelled<91, SWITZERLAND>, "nonante et un"),     "91 (Switzerland)");
+static_assert(equals(spelled<75, BELGIUM>,     "septante-cinq"),     "75 (Belgium)");
+static_assert(equals(spelled<80, OCTANTE>,     "octante"),           "80 (octante)");
+
+
+//=================================================================================================
+// Extremes
+
+static_assert(equals(spelled<UINT64_MAX>,
+    "dix-huit trillions quatre cent quarante-six billiards sept cent quarante-quatre billions "
+    "soixante-treize milliards sept cent neuf millions cinq cent cinquante et un mille six cent quinze"),
+    "UINT64_MAX");
+static_assert(equals(spelled<INT64_MIN+1>,
+    "moins neuf trillions deux cent vingt-trois billiards trois cent soixante-douze billions "
+    "trente-six milliards huit cent cinquante-quatre millions sept cent soixante-quinze mille huit cent sept"),
+    "INT64_MIN+1");
+
+#if RMGR_NSFR_HAS_INT128
+static_assert(equals(spelled<internal::uint128_t(UINT64_C(1000000000000000000)) * UINT64_C(1000000000000000000) * 2u>, "deux sextillions"),
+    "2*10^36");
+#endif
+
+static_assert(spelled<UINT64_MAX>.size() <= max_spelled_length<uint64_t>(), "max_spelled_length<uint64_t>()");
+static_assert(spelled<INT64_MIN+1>.size() <= max_spelled_length<int64_t>(), "max_spelled_length<int64_t>()");
+
+#endif // RMGR_NSFR_CPLUSPLUS >= 201703L
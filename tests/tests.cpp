@@ -52,11 +52,18 @@
  */
 
 #include <rmgr/nsfr.h>
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
+#include <climits>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <vector>
 
 
 using namespace rmgr::nsfr;
@@ -75,6 +82,40 @@ bool assert_spellout(int line, T value, unsigned options, const char* expectedNa
         fprintf(stderr, "%s(%d): %" PRIdMAX " was spelled out as \"%s\" instead of \"%s\"\n", __FILE__, line, intmax_t(value), name.c_str(), expectedName);
         return 0;
     }
+
+    // The other APIs must all agree with spell_out()
+    char buffer[512];
+    const to_words_result result = to_words(buffer, buffer + sizeof(buffer), value, options);
+    if (result.ec != std::errc() || std::string(buffer, result.ptr) != expectedName)
+    {
+        fprintf(stderr, "%s(%d): to_words() disagrees with spell_out() for %" PRIdMAX "\n", __FILE__, line, intmax_t(value));
+        return 0;
+    }
+    const size_t length = name.size();
+    if (to_words(buffer, buffer + length - 1, value, options).ec != std::errc::value_too_large)
+    {
+        fprintf(stderr, "%s(%d): to_words() did not detect the buffer is too small for %" PRIdMAX "\n", __FILE__, line, intmax_t(value));
+        return 0;
+    }
+    if (spelled_length(value, options) != length)
+    {
+        fprintf(stderr, "%s(%d): spelled_length() disagrees with spell_out() for %" PRIdMAX "\n", __FILE__, line, intmax_t(value));
+        return 0;
+    }
+    std::string appended("> ");
+    append_to(appended, value, options);
+    if (appended.compare(0, 2, "> ") != 0 || appended.compare(2, std::string::npos, expectedName) != 0)
+    {
+        fprintf(stderr, "%s(%d): append_to() disagrees with spell_out() for %" PRIdMAX "\n", __FILE__, line, intmax_t(value));
+        return 0;
+    }
+    const profile prof(options);
+    if (prof.spell_out(value) != expectedName || prof.spelled_length(value) != length)
+    {
+        fprintf(stderr, "%s(%d): profile disagrees with spell_out() for %" PRIdMAX "\n", __FILE__, line, intmax_t(value));
+        return 0;
+    }
+
     return 1;
 }
 
@@ -1169,6 +1210,20 @@ static unsigned test_large_cardinals(unsigned type)
 
     ASSERT_SPELLOUT(UINT32_MAX, type, u8"quatre milliards deux cent quatre-vingt-quatorze millions neuf cent soixante-sept mille deux cent quatre-vingt-quinze");
     ASSERT_SPELLOUT(UINT64_MAX, type, u8"dix-huit trillions quatre cent quarante-six billiards sept cent quarante-quatre billions soixante-treize milliards sept cent neuf millions cinq cent cinquante et un mille six cent quinze");
+    ASSERT_SPELLOUT(INT64_MIN,  type, u8"moins neuf trillions deux cent vingt-trois billiards trois cent soixante-douze billions trente-six milliards huit cent cinquante-quatre millions sept cent soixante-quinze mille huit cent huit");
+
+#if RMGR_NSFR_HAS_INT128
+    const internal::uint128_t e18 = UINT64_C(1000000000000000000);
+    ASSERT_SPELLOUT(e18 * 1000u,                    type, u8"un trilliard");
+    ASSERT_SPELLOUT(e18 * 2000000u + 1u,            type, u8"deux quadrillions un");
+    if (type & CARDINAL_AS_ORDINAL)
+        ASSERT_SPELLOUT(e18 * e18 * 80u,            type, u8"quatre-vingt sextillions");
+    else
+        ASSERT_SPELLOUT(e18 * e18 * 80u,            type, u8"quatre-vingts sextillions");
+    ASSERT_SPELLOUT(~internal::uint128_t(0),        type, u8"trois cent quarante sextillions deux cent quatre-vingt-deux quintilliards trois cent soixante-six quintillions neuf cent vingt quadrilliards neuf cent trente-huit quadrillions quatre cent soixante-trois trilliards quatre cent soixante-trois trillions trois cent soixante-quatorze billiards six cent sept billions quatre cent trente et un milliards sept cent soixante-huit millions deux cent onze mille quatre cent cinquante-cinq");
+    ASSERT_SPELLOUT(-internal::int128_t(e18 * e18), type, u8"moins un sextillion");
+    ASSERT_SPELLOUT(internal::int128_t(internal::uint128_t(1) << 127), type, u8"moins cent soixante-dix sextillions cent quarante et un quintilliards cent quatre-vingt-trois quintillions quatre cent soixante quadrilliards quatre cent soixante-neuf quadrillions deux cent trente et un trilliards sept cent trente et un trillions six cent quatre-vingt-sept billiards trois cent trois billions sept cent quinze milliards huit cent quatre-vingt-quatre millions cent cinq mille sept cent vingt-huit");
+#endif
 
     return succeeded;
 }
@@ -1205,6 +1260,917 @@ static unsigned test_large_ordinals(unsigned type)
 }
 
 
+template<typename T>
+static bool assert_max_spelled_length(int line, unsigned options)
+{
+    ++g_testCount;
+    const intmax_t first = (options & (ORDINAL | ORDINAL_SUFFIX)) ? 0 : intmax_t(std::numeric_limits<T>::min());
+    const intmax_t last  = intmax_t(std::numeric_limits<T>::max());
+    size_t actualMax = 0;
+    for (intmax_t value = first; value <= last; ++value)
+    {
+        const size_t length = spelled_length(T(value), options);
+        if (length > actualMax)
+            actualMax = length;
+    }
+    if (max_spelled_length<T>(options) != actualMax)
+    {
+        fprintf(stderr, "%s(%d): max_spelled_length() is %u instead of %u for options 0x%X\n", __FILE__, line, unsigned(max_spelled_length<T>(options)), unsigned(actualMax), options);
+        return 0;
+    }
+    return 1;
+}
+
+
+template<typename T>
+static bool assert_spelled_length_bound(int line, T value, unsigned options)
+{
+    ++g_testCount;
+    if (spelled_length(value, options) > max_spelled_length<T>(options))
+    {
+        fprintf(stderr, "%s(%d): %" PRIdMAX " is longer than max_spelled_length()\n", __FILE__, line, intmax_t(value));
+        return 0;
+    }
+    return 1;
+}
+
+#define ASSERT_MAX_SPELLED_LENGTH(type, options)           succeeded += assert_max_spelled_length<type>(__LINE__, options)
+#define ASSERT_SPELLED_LENGTH_BOUND(type, value, options)  succeeded += assert_spelled_length_bound<type>(__LINE__, value, options)
+
+
+static unsigned test_spelled_lengths()
+{
+    unsigned succeeded = 0;
+
+    // Usable at compile time
+    char buffer[max_spelled_length<int>()];
+    const to_words_result result = to_words(buffer, buffer + sizeof(buffer), INT_MIN);
+    ++g_testCount;
+    succeeded += (result.ec == std::errc());
+
+    static const unsigned variants[] =
+    {
+        FRANCE, BELGIUM, SWITZERLAND, SEPTANTE, OCTANTE, HUITANTE, NONANTE, SEPTANTE|OCTANTE, OCTANTE|NONANTE,
+        HUITANTE|NONANTE, SEPTANTE|OCTANTE|NONANTE, CENT_1100_1999
+    };
+    static const unsigned types[] = {CARDINAL, CARDINAL_AS_ORDINAL, ORDINAL, ORDINAL_SUFFIX};
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v)
+    {
+        for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t)
+        {
+            for (unsigned gender = MASCULINE; gender <= FEMININE; ++gender)
+            {
+                const unsigned options = variants[v] | types[t] | gender;
+                ASSERT_MAX_SPELLED_LENGTH(char,           options);
+                ASSERT_MAX_SPELLED_LENGTH(signed char,    options);
+                ASSERT_MAX_SPELLED_LENGTH(unsigned char,  options);
+                ASSERT_MAX_SPELLED_LENGTH(signed short,   options);
+                ASSERT_MAX_SPELLED_LENGTH(unsigned short, options);
+
+                ASSERT_SPELLED_LENGTH_BOUND(int,       INT_MAX,    options);
+                ASSERT_SPELLED_LENGTH_BOUND(unsigned,  UINT_MAX,   options);
+                ASSERT_SPELLED_LENGTH_BOUND(long long, LLONG_MAX,  options);
+                ASSERT_SPELLED_LENGTH_BOUND(long long, UINT64_C(4497497497497497497), options);
+                ASSERT_SPELLED_LENGTH_BOUND(unsigned long long, ULLONG_MAX, options);
+                if (!(options & (ORDINAL | ORDINAL_SUFFIX)))
+                {
+                    ASSERT_SPELLED_LENGTH_BOUND(int,       INT_MIN,   options);
+                    ASSERT_SPELLED_LENGTH_BOUND(long long, LLONG_MIN, options);
+                    ASSERT_SPELLED_LENGTH_BOUND(long long, -INT64_C(4497497497497497497), options);
+                }
+            }
+        }
+    }
+
+    // Reached by actual numbers for 64-bit types
+    const uint64_t longest = UINT64_C(17497497497497497497);
+    ++g_testCount;
+    succeeded += (spelled_length(longest) == max_spelled_length<uint64_t>());
+    ++g_testCount;
+    succeeded += (spelled_length(longest, ORDINAL) == max_spelled_length<uint64_t>(ORDINAL));
+    ++g_testCount;
+    succeeded += (spelled_length(-INT64_C(4497497497497497497)) == max_spelled_length<int64_t>());
+
+    // Array version
+    const unsigned values[4] = {0, 80, 81, 1000000};
+    size_t lengths[4];
+    ++g_testCount;
+    succeeded += (spelled_lengths(values, 4, lengths) == 5+13+15+10 && lengths[0] == 5 && lengths[1] == 13 && lengths[2] == 15 && lengths[3] == 10);
+
+    return succeeded;
+}
+
+
+#if RMGR_NSFR_HAS_PMR
+/**
+ * @brief Memory resource that counts the allocations it forwards to the default one
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    unsigned allocationCount = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocationCount;
+        return std::pmr::get_default_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::get_default_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+#endif
+
+
+template<typename Column>
+static bool assert_column(int line, const Column& column, const uint32_t* values, size_t count, const unsigned* options)
+{
+    ++g_testCount;
+    if (column.size() != count)
+    {
+        fprintf(stderr, "%s(%d): column has %u elements instead of %u\n", __FILE__, line, unsigned(column.size()), unsigned(count));
+        return 0;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (column.str(i) != spell_out(values[i], options[i]))
+        {
+            fprintf(stderr, "%s(%d): element #%u of the column is \"%s\"\n", __FILE__, line, unsigned(i), column.str(i).c_str());
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#define ASSERT_COLUMN(column, values, count, options)  succeeded += assert_column(__LINE__, column, values, count, options)
+
+
+static unsigned test_batches()
+{
+    unsigned succeeded = 0;
+
+    const size_t count = 10000;
+    std::vector<uint32_t> values(count);
+    std::vector<unsigned> options(count);
+    std::vector<unsigned> sameOptions(count, FEMININE);
+    for (size_t i = 0; i < count; ++i)
+    {
+        values[i]  = uint32_t(i * 2654435761u);
+        options[i] = (i % 3 == 0) ? ORDINAL : (i % 3 == 1) ? BELGIUM : CARDINAL_AS_ORDINAL|FEMININE;
+    }
+
+    spelled_column column;
+    spell_out_batch(column, values.data(), count, FEMININE);
+    ASSERT_COLUMN(column, values.data(), count, sameOptions.data());
+
+    column.clear();
+    spell_out_batch(column, values.data(), count, options.data());
+    ASSERT_COLUMN(column, values.data(), count, options.data());
+
+    // Whatever the number of threads, parallel batches give the same column
+    static const unsigned threadCounts[] = {0, 1, 3, 8};
+    for (size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); ++t)
+    {
+        column.clear();
+        spell_out_parallel(column, values.data(), count, FEMININE, threadCounts[t]);
+        ASSERT_COLUMN(column, values.data(), count, sameOptions.data());
+    }
+
+    // Appending to a non-empty column, with too few values to split
+    spelled_column parallelColumn;
+    spell_out_batch(parallelColumn, values.data(), 10, FEMININE);
+    spell_out_parallel(parallelColumn, values.data() + 10, 5, FEMININE, 4);
+    spell_out_parallel(parallelColumn, values.data() + 15, 0, FEMININE, 4);
+    spell_out_parallel(parallelColumn, values.data() + 15, count - 15, FEMININE, 4);
+    ASSERT_COLUMN(parallelColumn, values.data(), count, sameOptions.data());
+
+#if RMGR_NSFR_HAS_PMR
+    CountingResource resource;
+    {
+        pmr::spelled_column pmrColumn(&resource);
+        spell_out_batch(pmrColumn, values.data(), count, options.data());
+        ASSERT_COLUMN(pmrColumn, values.data(), count, options.data());
+
+        // Only a logarithmic number of allocations
+        ++g_testCount;
+        succeeded += (resource.allocationCount < 40);
+        ++g_testCount;
+        succeeded += (pmrColumn[1] == spell_out(values[1], options[1]));
+    }
+#endif
+
+    return succeeded;
+}
+
+
+static unsigned test_group_tables()
+{
+    unsigned succeeded = 0;
+
+    // Every number within [0;999] must match the rules, alone or combined with numerals
+    static const uint64_t multipliers[] = {1, 1000, 1001, 1000000, 1000001, UINT64_C(1000000000000000)};
+    static const unsigned types[] = {CARDINAL, CARDINAL_AS_ORDINAL, ORDINAL};
+    for (unsigned variant = 0; variant < 32; ++variant)
+    {
+        const unsigned variantOptions = ((variant &  1) ? SEPTANTE       : 0)
+                                      | ((variant &  2) ? OCTANTE        : 0)
+                                      | ((variant &  4) ? HUITANTE       : 0)
+                                      | ((variant &  8) ? NONANTE        : 0)
+                                      | ((variant & 16) ? CENT_1100_1999 : 0);
+        for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t)
+        {
+            for (unsigned gender = MASCULINE; gender <= FEMININE; ++gender)
+            {
+                const unsigned options = variantOptions | types[t] | gender;
+                for (size_t m = 0; m < sizeof(multipliers) / sizeof(multipliers[0]); ++m)
+                {
+                    ++g_testCount;
+                    unsigned value = 0;
+                    while (value < 1000u && spell_out(value * multipliers[m], options) == internal::spell_out_reference(value * multipliers[m], options))
+                        ++value;
+                    if (value < 1000u)
+                        fprintf(stderr, "%s(%d): %" PRIu64 " doesn't match the rules with options 0x%X\n", __FILE__, __LINE__, value * multipliers[m], options);
+                    else
+                        ++succeeded;
+                }
+            }
+        }
+    }
+
+    // Random numbers with random zero groups, to exercise the handling of remainders
+    static const unsigned options[] = {CARDINAL, ORDINAL|FEMININE, CARDINAL_AS_ORDINAL, CARDINAL|CENT_1100_1999, ORDINAL|CENT_1100_1999, BELGIUM, SWITZERLAND|ORDINAL};
+    uint64_t seed = 42;
+    for (unsigned i = 0; i < 20000; ++i)
+    {
+        uint64_t value = 0;
+        for (unsigned g = 0; g < 7; ++g)
+        {
+            seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+            const unsigned group = unsigned(seed >> 33) % 2000u;
+            value = value * 1000u + ((group < 1000u) ? group : 0u);
+        }
+        for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+        {
+            ++g_testCount;
+            if (spell_out(value, options[o]) == internal::spell_out_reference(value, options[o]))
+                ++succeeded;
+            else
+                fprintf(stderr, "%s(%d): %" PRIu64 " doesn't match the rules with options 0x%X\n", __FILE__, __LINE__, value, options[o]);
+        }
+    }
+
+    return succeeded;
+}
+
+
+#if RMGR_NSFR_HAS_INT128
+static unsigned test_int128()
+{
+    unsigned succeeded = 0;
+
+    typedef internal::uint128_t uint128_t;
+    typedef internal::int128_t  int128_t;
+    const uint128_t e18 = UINT64_C(1000000000000000000);
+
+    ASSERT_SPELLOUT(e18 * e18,             ORDINAL,          u8"sextillionième");
+    ASSERT_SPELLOUT(e18 * e18 * 2u + 80u,  ORDINAL,          u8"deux sextillions quatre-vingtième");
+    ASSERT_SPELLOUT(e18 * 1000u,           ORDINAL_SUFFIX,   u8"e");
+
+    // Random values of all magnitudes must match the rules
+    static const unsigned options[] = {CARDINAL, ORDINAL|FEMININE, CARDINAL_AS_ORDINAL, CARDINAL|CENT_1100_1999, BELGIUM, SWITZERLAND|ORDINAL};
+    uint64_t seed = 42;
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        uint128_t value = 0;
+        for (unsigned g = 0; g < 13; ++g)
+        {
+            seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+            const unsigned group = unsigned(seed >> 33) % 2000u;
+            value = value * 1000u + ((group < 1000u) ? group : 0u);
+        }
+        value >>= (i % 64u);
+        for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+        {
+            ++g_testCount;
+            if (spell_out(value, options[o]) == internal::spell_out_reference(value, options[o]))
+                ++succeeded;
+            else
+                fprintf(stderr, "%s(%d): a 128-bit value doesn't match the rules with options 0x%X\n", __FILE__, __LINE__, options[o]);
+        }
+        ASSERT_SPELLED_LENGTH_BOUND(uint128_t, value, CARDINAL);
+        ASSERT_SPELLED_LENGTH_BOUND(int128_t, -int128_t(value >> 1), CARDINAL);
+    }
+
+    return succeeded;
+}
+#endif
+
+
+template<unsigned Options, typename T>
+static bool assert_profile(int line, T value)
+{
+    ++g_testCount;
+    const std::string expected = spell_out(value, Options);
+    char buffer[512];
+    const to_words_result result = to_words<Options>(buffer, buffer + sizeof(buffer), value);
+    std::string appended;
+    append_to<Options>(appended, value);
+    if (   spell_out<Options>(value) != expected
+        || result.ec != std::errc() || std::string(buffer, result.ptr) != expected
+        || appended != expected
+        || spelled_length<Options>(value) != expected.size())
+    {
+        fprintf(stderr, "%s(%d): spell_out<0x%X>() disagrees with spell_out() for %" PRIdMAX "\n", __FILE__, line, Options, intmax_t(value));
+        return false;
+    }
+    return true;
+}
+
+#define ASSERT_PROFILE(options, value)  succeeded += assert_profile<options>(__LINE__, value)
+
+
+static unsigned test_profiles()
+{
+    unsigned succeeded = 0;
+
+    ++g_testCount;
+    if (profile(ORDINAL | FEMININE | BELGIUM).options() == (ORDINAL | FEMININE | BELGIUM))
+        ++succeeded;
+    else
+        fprintf(stderr, "%s(%d): profile doesn't return its options\n", __FILE__, __LINE__);
+
+    ASSERT_PROFILE(CARDINAL,                      80);
+    ASSERT_PROFILE(CARDINAL,                      -71);
+    ASSERT_PROFILE(CARDINAL,                      UINT64_C(18446744073709551615));
+    ASSERT_PROFILE(ORDINAL | FEMININE,            80);
+    ASSERT_PROFILE(ORDINAL | FEMININE,            1);
+    ASSERT_PROFILE(ORDINAL | SECOND,              2);
+    ASSERT_PROFILE(ORDINAL,                       2000000u);
+    ASSERT_PROFILE(CARDINAL_AS_ORDINAL,           80000000);
+    ASSERT_PROFILE(ORDINAL_SUFFIX | FEMININE,     1);
+    ASSERT_PROFILE(CENT_1100_1999,                1180);
+    ASSERT_PROFILE(CENT_1100_1999 | ORDINAL,      1100);
+    ASSERT_PROFILE(CENT_1100_1999 | CARDINAL_AS_ORDINAL, 1200);
+    ASSERT_PROFILE(SWITZERLAND | OCTANTE,         80080080);
+    ASSERT_PROFILE(BELGIUM | FEMININE,            71071);
+
+    return succeeded;
+}
+
+
+static bool assert_parse(int line, const char* str, size_t expectedLength, std::errc expectedEc, intmax_t expectedValue, unsigned expectedOptions)
+{
+    ++g_testCount;
+    const parse_result result = parse(str, str + strlen(str));
+    const intmax_t     value  = result.negative ? -intmax_t(result.value) : intmax_t(result.value);
+    if (size_t(result.ptr - str) != expectedLength || result.ec != expectedEc || value != expectedValue || result.options != expectedOptions)
+    {
+        fprintf(stderr, "%s(%d): \"%s\" was parsed as %" PRIdMAX " (options 0x%X, length %u)\n", __FILE__, line, str, value, result.options, unsigned(result.ptr - str));
+        return false;
+    }
+    return true;
+}
+
+#define ASSERT_PARSE(str, length, ec, value, options)  succeeded += assert_parse(__LINE__, str, length, ec, value, options)
+
+
+static unsigned test_parse()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_PARSE(u8"zéro",                              5, std::errc(), 0, CARDINAL);
+    ASSERT_PARSE(u8"première",                          9, std::errc(), 1, ORDINAL|FEMININE);
+    ASSERT_PARSE("seconde",                             7, std::errc(), 2, ORDINAL|FEMININE|SECOND);
+    ASSERT_PARSE("vingt et une",                       12, std::errc(), 21, FEMININE);
+    ASSERT_PARSE("moins soixante et onze",             22, std::errc(), -71, CARDINAL);
+    ASSERT_PARSE(u8"quatre-vingtième",                 17, std::errc(), 80, ORDINAL);
+    ASSERT_PARSE("deux-cent-vingt-et-un",              21, std::errc(), 221, CARDINAL);
+    ASSERT_PARSE("septante-sept",                      13, std::errc(), 77, SEPTANTE);
+    ASSERT_PARSE("octante et un",                      13, std::errc(), 81, OCTANTE);
+    ASSERT_PARSE("nonante-neuf",                       12, std::errc(), 99, NONANTE);
+    ASSERT_PARSE("douze cent trente-quatre",           24, std::errc(), 1234, CENT_1100_1999);
+    ASSERT_PARSE(u8"millionième",                      12, std::errc(), 1000000, ORDINAL);
+
+    // Parsing stops at the first word that can't be part of the number
+    ASSERT_PARSE("vingt euros",                         5, std::errc(), 20, CARDINAL);
+    ASSERT_PARSE("trois deux",                          5, std::errc(), 3, CARDINAL);
+    ASSERT_PARSE("cent cent",                           4, std::errc(), 100, CARDINAL);
+    ASSERT_PARSE("vingt et",                            5, std::errc(), 20, CARDINAL);
+    ASSERT_PARSE("mille million",                       5, std::errc(), 1000, CARDINAL);
+    ASSERT_PARSE(u8"deuxième page",                     9, std::errc(), 2, ORDINAL);
+
+    // Errors
+    ASSERT_PARSE("",                                    0, std::errc::invalid_argument, 0, CARDINAL);
+    ASSERT_PARSE("moins",                               0, std::errc::invalid_argument, 0, CARDINAL);
+    ASSERT_PARSE("Vingt",                               0, std::errc::invalid_argument, 0, CARDINAL);
+    ASSERT_PARSE("dix-neuf trillions",                 18, std::errc::result_out_of_range, 0, CARDINAL);
+
+    // UINTMAX_MAX parses, UINTMAX_MAX + 1 only overflows with its last group
+    static const char largest[] = "dix-huit trillions quatre cent quarante-six billiards sept cent quarante-quatre billions soixante-treize milliards "
+                                  "sept cent neuf millions cinq cent cinquante et un mille six cent quinze";
+    static const char beyond[]  = "dix-huit trillions quatre cent quarante-six billiards sept cent quarante-quatre billions soixante-treize milliards "
+                                  "sept cent neuf millions cinq cent cinquante et un mille six cent seize";
+    const parse_result largestResult = parse(largest, largest + strlen(largest));
+    const parse_result beyondResult  = parse(beyond,  beyond  + strlen(beyond));
+    ++g_testCount;
+    succeeded += (largestResult.ec == std::errc() && largestResult.value == UINTMAX_MAX && largestResult.ptr == largest + strlen(largest));
+    ++g_testCount;
+    succeeded += (beyondResult.ec == std::errc::result_out_of_range && beyondResult.value == 0u && beyondResult.ptr == beyond + strlen(beyond));
+
+    // Everything spell_out() produces must be parsed back
+    char buffer[512];
+    ++g_testCount;
+    uint32_t value = 0;
+    for (; value <= 10000000u; ++value)
+    {
+        const to_words_result words  = to_words(buffer, buffer + sizeof(buffer), value);
+        const parse_result    parsed = parse(buffer, words.ptr);
+        if (parsed.ptr != words.ptr || parsed.ec != std::errc() || parsed.value != value)
+            break;
+    }
+    if (value <= 10000000u)
+        fprintf(stderr, "%s(%d): %u could not be parsed back\n", __FILE__, __LINE__, value);
+    else
+        ++succeeded;
+
+    static const unsigned options[] = {FEMININE, ORDINAL, ORDINAL|FEMININE, ORDINAL|SECOND, CARDINAL_AS_ORDINAL, BELGIUM, SWITZERLAND, OCTANTE, CENT_1100_1999, ORDINAL|CENT_1100_1999};
+    for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+    {
+        ++g_testCount;
+        value = 0;
+        for (; value <= 10000000u; value += (value < 100000u) ? 1u : 997u)
+        {
+            const to_words_result words  = to_words(buffer, buffer + sizeof(buffer), value, options[o]);
+            const parse_result    parsed = parse(buffer, words.ptr);
+            if (parsed.ptr != words.ptr || parsed.ec != std::errc() || parsed.value != value || (parsed.options & ORDINAL) != (options[o] & ORDINAL))
+                break;
+        }
+        if (value <= 10000000u)
+            fprintf(stderr, "%s(%d): %u could not be parsed back with options 0x%X\n", __FILE__, __LINE__, value, options[o]);
+        else
+            ++succeeded;
+    }
+
+    static const uint64_t largeValues[] = {UINT64_MAX, UINT64_C(1000000000000000000), UINT64_C(2000000000000000001), UINT64_C(80080080080080080)};
+    for (size_t i = 0; i < sizeof(largeValues) / sizeof(largeValues[0]); ++i)
+    {
+        ++g_testCount;
+        const std::string  words  = spell_out(largeValues[i]);
+        const parse_result parsed = parse(words.data(), words.data() + words.size());
+        if (parsed.ec == std::errc() && parsed.value == largeValues[i])
+            ++succeeded;
+        else
+            fprintf(stderr, "%s(%d): %" PRIu64 " could not be parsed back\n", __FILE__, __LINE__, largeValues[i]);
+    }
+
+    return succeeded;
+}
+
+
+static bool assert_decimal(int line, const char* digits, unsigned options, const char* expected)
+{
+    ++g_testCount;
+    const std::string result = spell_out_decimal(digits, digits + strlen(digits), options);
+    if (result != expected)
+    {
+        fprintf(stderr, "%s(%d): spell_out_decimal(\"%s\") returned \"%s\" instead of \"%s\"\n", __FILE__, line, digits, result.c_str(), expected);
+        return false;
+    }
+    return true;
+}
+
+#define ASSERT_DECIMAL(digits, options, expected)  succeeded += assert_decimal(__LINE__, digits, options, expected)
+
+
+static void append_chunk(void* context, const char* str, size_t length)
+{
+    static_cast<std::string*>(context)->append(str, length);
+}
+
+
+static unsigned test_decimal()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_DECIMAL("0",        CARDINAL,        u8"zéro");
+    ASSERT_DECIMAL("-000",     CARDINAL,        u8"zéro");
+    ASSERT_DECIMAL("0001",     ORDINAL,         u8"premier");
+    ASSERT_DECIMAL("-80",      CARDINAL,        u8"moins quatre-vingts");
+    ASSERT_DECIMAL("1000000000000000000000000000000000000000",      CARDINAL,  u8"un sextilliard");
+    ASSERT_DECIMAL("2000000000000000000000000000000000000000000080", CARDINAL,  u8"deux septilliards quatre-vingts");
+    ASSERT_DECIMAL("2000000000000000000000000000000000000000000080", ORDINAL,   u8"deux septilliards quatre-vingtième");
+    ASSERT_DECIMAL("2000000000000000000000000000000000000000000000", ORDINAL,   u8"deux septilliardième");
+    ASSERT_DECIMAL("80000000000000000000000000000000000000000000000", ORDINAL_SUFFIX, u8"e");
+
+    // Invalid strings output nothing
+    ASSERT_DECIMAL("",         CARDINAL,        "");
+    ASSERT_DECIMAL("-",        CARDINAL,        "");
+    ASSERT_DECIMAL("12a",      CARDINAL,        "");
+    ASSERT_DECIMAL("+12",      CARDINAL,        "");
+    ASSERT_DECIMAL("-12",      ORDINAL,         "");
+    const char  invalid[] = "1 2";
+    std::string str       = "x";
+    ++g_testCount;
+    succeeded += (append_decimal_to(str, invalid, invalid + 3) == std::errc::invalid_argument && str == "x");
+
+    // Names beyond the tables
+    const struct {unsigned power; const char* name;} scales[] =
+    {
+        {  60, u8"décillion"},   {  63, u8"décilliard"},  {  66, u8"undécillion"},
+        { 102, u8"septendécillion"},                       { 120, u8"vigintillion"},
+        { 138, u8"tresvigintillion"},                      { 600, u8"centillion"},
+        {3000, u8"quingentillion"},                        {6000, u8"millinillion"},
+        {6006, u8"millimillion"},
+    };
+    for (size_t i = 0; i < sizeof(scales) / sizeof(scales[0]); ++i)
+    {
+        const std::string digits = "1" + std::string(scales[i].power, '0');
+        ASSERT_DECIMAL(digits.c_str(), CARDINAL, (std::string("un ") + scales[i].name).c_str());
+        ASSERT_DECIMAL(("3" + digits.substr(1)).c_str(), CARDINAL, (std::string("trois ") + scales[i].name + "s").c_str());
+        ASSERT_DECIMAL(digits.c_str(), ORDINAL,  (std::string(scales[i].name) + u8"ième").c_str());
+    }
+
+    // Values that fit in native integers must be spelled just like them
+    static const unsigned options[] = {CARDINAL, ORDINAL|FEMININE, CARDINAL_AS_ORDINAL, CARDINAL|CENT_1100_1999, BELGIUM, SWITZERLAND|ORDINAL};
+    uint64_t seed = 1234;
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const uint64_t value = seed >> (i % 64u);
+        char digits[32];
+        snprintf(digits, sizeof(digits), "%" PRIu64, value);
+        for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+            ASSERT_DECIMAL(digits, options[o], spell_out(value, options[o]).c_str());
+    }
+#if RMGR_NSFR_HAS_INT128
+    typedef internal::uint128_t uint128_t;
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        uint128_t value = 0;
+        for (unsigned g = 0; g < 13; ++g)
+        {
+            seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+            const unsigned group = unsigned(seed >> 33) % 2000u;
+            value = value * 1000u + ((group < 1000u) ? group : 0u);
+        }
+        value >>= (i % 64u);
+        char digits[48];
+        char* cur = digits + sizeof(digits);
+        *--cur = '\0';
+        do
+        {
+            *--cur = char('0' + unsigned(value % 10u));
+            value /= 10u;
+        }
+        while (value != 0u);
+        for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+        {
+            uint128_t parsed = 0;
+            for (const char* c = cur; *c != '\0'; ++c)
+                parsed = parsed * 10u + unsigned(*c - '0');
+            ASSERT_DECIMAL(cur, options[o], spell_out(parsed, options[o]).c_str());
+        }
+    }
+#endif
+
+    // Very long strings are streamed to the callback
+    const std::string digits(10000, '7');
+    std::string streamed;
+    ++g_testCount;
+    succeeded += (spell_out_decimal(digits.data(), digits.data() + digits.size(), CARDINAL, append_chunk, &streamed) == std::errc()
+               && streamed == spell_out_decimal(digits.data(), digits.data() + digits.size())
+               && streamed.compare(0, 42, "sept millisesexagintasescentilliards sept ") == 0
+               && streamed.compare(streamed.size() - 28, 28, " sept cent soixante-dix-sept") == 0);
+
+    return succeeded;
+}
+
+
+static bool assert_fixed(int line, intmax_t mantissa, unsigned scale, unsigned options, const char* expected)
+{
+    ++g_testCount;
+    const std::string result = spell_out_fixed(mantissa, scale, options);
+    if (result != expected)
+    {
+        fprintf(stderr, "%s(%d): spell_out_fixed(%" PRIdMAX ", %u) returned \"%s\" instead of \"%s\"\n", __FILE__, line, mantissa, scale, result.c_str(), expected);
+        return false;
+    }
+    return true;
+}
+
+
+static bool assert_double(int line, double value, unsigned options, const char* expected)
+{
+    ++g_testCount;
+    const std::string result = spell_out(value, options);
+    if (result != expected)
+    {
+        fprintf(stderr, "%s(%d): spell_out(%.17g) returned \"%s\" instead of \"%s\"\n", __FILE__, line, value, result.c_str(), expected);
+        return false;
+    }
+    return true;
+}
+
+#define ASSERT_FIXED(mantissa, scale, options, expected)  succeeded += assert_fixed(__LINE__, mantissa, scale, options, expected)
+#define ASSERT_DOUBLE(value, options, expected)           succeeded += assert_double(__LINE__, value, options, expected)
+
+
+static unsigned test_fixed()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_FIXED(123456,  2, CARDINAL,   u8"mille deux cent trente-quatre virgule cinquante-six");
+    ASSERT_FIXED(105,     2, CARDINAL,   u8"un virgule zéro cinq");
+    ASSERT_FIXED(150,     2, CARDINAL,   u8"un virgule cinquante");
+    ASSERT_FIXED(100,     2, CARDINAL,   u8"un");
+    ASSERT_FIXED(-5,      3, CARDINAL,   u8"moins zéro virgule zéro zéro cinq");
+    ASSERT_FIXED(0,       3, CARDINAL,   u8"zéro");
+    ASSERT_FIXED(8080,    2, CARDINAL,   u8"quatre-vingts virgule quatre-vingts");
+    ASSERT_FIXED(2121,    2, FEMININE,   u8"vingt et une virgule vingt et une");
+    ASSERT_FIXED(7171,    2, BELGIUM,    u8"septante et un virgule septante et un");
+    ASSERT_FIXED(42,      0, CARDINAL,   u8"quarante-deux");
+    ASSERT_FIXED(42,      4, ORDINAL,    "");
+    ++g_testCount;
+    succeeded += (spell_out_fixed(15, 1, CARDINAL, "point") == "un point cinq");
+
+    // Both parts must be spelled just like integers (the divisor stops growing once the integer part is zero)
+    uint64_t seed = 99;
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const intmax_t mantissa = intmax_t(seed >> (i % 64u)) / ((i & 1u) ? -7 : 3);
+        const unsigned scale    = unsigned(seed >> 59) % 20u;
+        uintmax_t magnitude = (mantissa < 0) ? 0u - uintmax_t(mantissa) : uintmax_t(mantissa);
+        uintmax_t divisor   = 1;
+        for (unsigned d = 0; d < scale && divisor <= magnitude; ++d)
+            divisor *= 10u;
+        std::string expected = ((mantissa < 0) ? "moins " : "") + spell_out(magnitude / divisor);
+        if (magnitude % divisor != 0u)
+        {
+            char digits[32];
+            snprintf(digits, sizeof(digits), "%0*" PRIuMAX, int(scale), magnitude % divisor);
+            expected += " virgule";
+            const char* cur = digits;
+            for (; *cur == '0'; ++cur)
+                expected += u8" zéro";
+            expected += " " + spell_out(strtoumax(cur, nullptr, 10));
+        }
+        ASSERT_FIXED(mantissa, scale, CARDINAL, expected.c_str());
+    }
+
+    ASSERT_DOUBLE(1234.56,  CARDINAL,    u8"mille deux cent trente-quatre virgule cinquante-six");
+    ASSERT_DOUBLE(0.005,    CARDINAL,    u8"zéro virgule zéro zéro cinq");
+    ASSERT_DOUBLE(-1.5,     CARDINAL,    u8"moins un virgule cinq");
+    ASSERT_DOUBLE(-0.0,     CARDINAL,    u8"zéro");
+    ASSERT_DOUBLE(80.0,     CARDINAL,    u8"quatre-vingts");
+    ASSERT_DOUBLE(1e21,     CARDINAL,    u8"un trilliard");
+    ASSERT_DOUBLE(1e-7,     CARDINAL,    u8"zéro virgule zéro zéro zéro zéro zéro zéro un");
+    ASSERT_DOUBLE(0.1+0.2,  CARDINAL,    u8"zéro virgule trente billiards quatre");
+    ASSERT_DOUBLE(1.0/0.0,  CARDINAL,    "");
+
+    // Errors and overflows
+    char buffer[16];
+    to_words_result result = to_words(buffer, buffer + sizeof(buffer), 0.5, ORDINAL);
+    ++g_testCount;
+    succeeded += (result.ec == std::errc::invalid_argument && result.ptr == buffer);
+    result = to_words(buffer, buffer + sizeof(buffer), 1234.56);
+    ++g_testCount;
+    succeeded += (result.ec == std::errc::value_too_large && result.ptr == buffer + sizeof(buffer));
+    result = to_words_fixed(buffer, buffer + sizeof(buffer), 15, 1);
+    ++g_testCount;
+    succeeded += (result.ec == std::errc() && std::string(buffer, result.ptr) == "un virgule cinq");
+
+    return succeeded;
+}
+
+
+static bool assert_amount(int line, intmax_t amount, const currency& cur, unsigned options, const char* expected)
+{
+    ++g_testCount;
+    const std::string result = spell_out_amount(amount, cur, options);
+    if (result != expected || (!result.empty() && result.size() > max_spelled_amount_length(cur, options)))
+    {
+        fprintf(stderr, "%s(%d): spell_out_amount(%" PRIdMAX ") returned \"%s\" instead of \"%s\"\n", __FILE__, line, amount, result.c_str(), expected);
+        return false;
+    }
+    return true;
+}
+
+#define ASSERT_AMOUNT(amount, cur, options, expected)  succeeded += assert_amount(__LINE__, amount, cur, options, expected)
+
+
+static unsigned test_amounts()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_AMOUNT(0,                   EURO,            CARDINAL,  u8"zéro euro");
+    ASSERT_AMOUNT(1,                   EURO,            CARDINAL,  u8"un centime");
+    ASSERT_AMOUNT(100,                 EURO,            CARDINAL,  u8"un euro");
+    ASSERT_AMOUNT(200,                 EURO,            CARDINAL,  u8"deux euros");
+    ASSERT_AMOUNT(8000,                EURO,            CARDINAL,  u8"quatre-vingts euros");
+    ASSERT_AMOUNT(123050,              EURO,            CARDINAL,  u8"mille deux cent trente euros et cinquante centimes");
+    ASSERT_AMOUNT(-2150,               EURO,            CARDINAL,  u8"moins vingt et un euros et cinquante centimes");
+    ASSERT_AMOUNT(100000000,           EURO,            CARDINAL,  u8"un million d'euros");
+    ASSERT_AMOUNT(200000000001,        EURO,            CARDINAL,  u8"deux milliards d'euros et un centime");
+    ASSERT_AMOUNT(100000200,           EURO,            CARDINAL,  u8"un million deux euros");
+    ASSERT_AMOUNT(7100,                EURO,            BELGIUM,   u8"septante et un euros");
+    ASSERT_AMOUNT(2101,                POUND_STERLING,  CARDINAL,  u8"vingt et une livres et un penny");
+    ASSERT_AMOUNT(100000000,           POUND_STERLING,  FEMININE,  u8"un million de livres");
+    ASSERT_AMOUNT(100,                 EURO,            ORDINAL,   "");
+
+    const currency yen = {"yen", "yens", MASCULINE, "", "", MASCULINE, 0};
+    ASSERT_AMOUNT(0,                   yen,             CARDINAL,  u8"zéro yen");
+    ASSERT_AMOUNT(180,                 yen,             CARDINAL,  u8"cent quatre-vingts yens");
+    ASSERT_AMOUNT(100000000,           yen,             CARDINAL,  u8"cent millions de yens");
+    const currency ounce = {"once", "onces", FEMININE, "millionième", "millionièmes", MASCULINE, 6};
+    ASSERT_AMOUNT(21000001,            ounce,           CARDINAL,  u8"vingt et une onces et un millionième");
+    const currency tooFine = {"once", "onces", FEMININE, "", "", MASCULINE, 10};
+    ASSERT_AMOUNT(21000001,            tooFine,         CARDINAL,  "");
+
+    // Columns hold the same spellings
+    static const intmax_t amounts[] = {0, 100, -2150, 100000000, 123050};
+    spelled_column column;
+    spell_out_amount_batch(column, amounts, 5, EURO, SWITZERLAND);
+    for (size_t i = 0; i < 5; ++i)
+    {
+        ++g_testCount;
+        succeeded += (column.str(i) == spell_out_amount(amounts[i], EURO, SWITZERLAND));
+    }
+    char buffer[8];
+    ++g_testCount;
+    succeeded += (to_words_amount(buffer, buffer + sizeof(buffer), 123050).ec == std::errc::value_too_large);
+    ++g_testCount;
+    succeeded += (to_words_amount(buffer, buffer + sizeof(buffer), 1, tooFine).ec == std::errc::invalid_argument);
+    ++g_testCount;
+    succeeded += (spell_out_amount(INTMAX_MIN + 99, POUND_STERLING).size() <= max_spelled_amount_length(POUND_STERLING));
+
+    return succeeded;
+}
+
+
+static unsigned test_counters()
+{
+    unsigned succeeded = 0;
+
+    // Every step must match a spelling from scratch, around all carries
+    static const unsigned  options[] = {CARDINAL, ORDINAL|FEMININE, CARDINAL_AS_ORDINAL, CENT_1100_1999, ORDINAL|CENT_1100_1999, BELGIUM, ORDINAL|SECOND, ORDINAL_SUFFIX};
+    static const uintmax_t starts[]  = {0, 1000900, 999999900, UINTMAX_C(999999999999900), UINTMAX_MAX - 100};
+    for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+    {
+        for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); ++s)
+        {
+            counter count(starts[s], options[o]);
+            const unsigned steps = (starts[s] == 0u) ? 30000u : 200u;
+            for (unsigned i = 0; i < steps; ++i, ++count)
+            {
+                ++g_testCount;
+                if (count.str() == spell_out(count.value(), options[o]))
+                    ++succeeded;
+                else
+                    fprintf(stderr, "%s(%d): counter spelled %" PRIuMAX " as \"%s\" with options 0x%X\n", __FILE__, __LINE__, count.value(), count.str().c_str(), options[o]);
+            }
+        }
+    }
+
+    counter count(80);
+    ++g_testCount;
+    succeeded += (count.str() == u8"quatre-vingts" && (++count).str() == u8"quatre-vingt-un");
+    count.reset(20);
+    ++g_testCount;
+    succeeded += (count.str() == u8"vingt" && (++count).str() == u8"vingt et un" && count.value() == 21u);
+
+    return succeeded;
+}
+
+
+static unsigned test_caches()
+{
+    unsigned succeeded = 0;
+
+    spelling_cache cache(64, 4);
+    const cached_spelling first = cache.spell_out(80);
+    ++g_testCount;
+    succeeded += (*first == u8"quatre-vingts" && cache.misses() == 1u && cache.hits() == 0u);
+    ++g_testCount;
+    succeeded += (cache.spell_out(80u) == first && cache.spell_out(int8_t(80)) == first && cache.hits() == 2u);
+
+    // Options are normalized, but negative values are distinct
+    ++g_testCount;
+    succeeded += (cache.spell_out(80, HUITANTE | OCTANTE) == cache.spell_out(80, HUITANTE) && cache.misses() == 2u);
+    ++g_testCount;
+    succeeded += (*cache.spell_out(-80) == u8"moins quatre-vingts" && *cache.spell_out(INTMAX_MIN) == spell_out(INTMAX_MIN));
+
+    // The size is bounded, and evicted spellings remain valid
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        ++g_testCount;
+        succeeded += (*cache.spell_out(i, ORDINAL) == spell_out(i, ORDINAL));
+    }
+    ++g_testCount;
+    succeeded += (cache.size() <= cache.capacity() && cache.capacity() == 64u && *first == u8"quatre-vingts");
+
+    // Frequently used values survive a stream of one-off ones
+    cache.clear();
+    unsigned hits = 0;
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        const uint64_t before = cache.hits();
+        cache.spell_out(i % 8u);
+        hits += unsigned(cache.hits() - before);
+        cache.spell_out(100000u + i);
+    }
+    ++g_testCount;
+    succeeded += (hits >= 900u && cache.size() == cache.capacity());
+
+    // Concurrent use
+    std::vector<std::thread> threads;
+    unsigned mismatches[4] = {};
+    for (unsigned t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&cache, &mismatches, t]()
+        {
+            for (unsigned i = 0; i < 20000; ++i)
+            {
+                const unsigned value = (i * 7919u + t) % 200u;
+                if (*cache.spell_out(value, FEMININE) != spell_out(value, FEMININE))
+                    ++mismatches[t];
+            }
+        });
+    }
+    for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+    ++g_testCount;
+    succeeded += (mismatches[0] + mismatches[1] + mismatches[2] + mismatches[3] == 0u);
+
+    return succeeded;
+}
+
+
+static unsigned test_dictionaries()
+{
+    unsigned succeeded = 0;
+
+    const char* const path = "rmgr-nsfr-tests.dict";
+    static const unsigned options[] = {CARDINAL, ORDINAL|FEMININE, SWITZERLAND|OCTANTE};
+    ++g_testCount;
+    succeeded += (write_dictionary(path, 20000, options, 3) == std::errc());
+
+    dictionary dict;
+    ++g_testCount;
+    succeeded += (dict.open(path) == std::errc() && dict.is_open() && dict.size() == 20000u);
+    for (unsigned o = 0; o < 3; ++o)
+    {
+        for (uintmax_t value = 0; value < 20000u; ++value)
+        {
+            const char* spelling = nullptr;
+            size_t      length   = 0;
+            ++g_testCount;
+            if (dict.find(value, options[o], spelling, length) && std::string(spelling, length) == spell_out(value, options[o]))
+                ++succeeded;
+            else
+                fprintf(stderr, "%s(%d): the dictionary doesn't hold the spelling of %" PRIuMAX " with options 0x%X\n", __FILE__, __LINE__, value, options[o]);
+        }
+    }
+
+    // Options are normalized, missing values and profiles are not found
+    const char* spelling = nullptr;
+    size_t      length   = 0;
+    ++g_testCount;
+    succeeded += (dict.contains(SWITZERLAND) && !dict.contains(ORDINAL) && !dict.find(20000, CARDINAL, spelling, length) && !dict.find(5, BELGIUM, spelling, length));
+
+    dictionary moved(std::move(dict));
+    ++g_testCount;
+    succeeded += (!dict.is_open() && moved.find(80, CARDINAL, spelling, length) && std::string(spelling, length) == u8"quatre-vingts");
+    moved.close();
+
+    // Other files are rejected
+    FILE* file = fopen(path, "wb");
+    fputs("Not a dictionary, but long enough to hold a header", file);
+    fclose(file);
+    ++g_testCount;
+    succeeded += (dict.open(path) == std::errc::invalid_argument && !dict.is_open());
+    remove(path);
+    ++g_testCount;
+    succeeded += (dict.open(path) == std::errc::no_such_file_or_directory);
+
+    // Counts whose spellings can't fit are rejected before spelling anything, and no file is created
+    ++g_testCount;
+    succeeded += (write_dictionary(path, UINT64_C(1000000000000), options, 3) == std::errc::value_too_large
+               && write_dictionary(path, UINTMAX_MAX, options, 3) == std::errc::value_too_large
+               && dict.open(path) == std::errc::no_such_file_or_directory);
+
+    return succeeded;
+}
+
+
 static unsigned test_cardinals()
 {
     unsigned succeeded = 0;
@@ -1241,12 +2207,665 @@ static unsigned test_ordinals()
 }
 
 
+static unsigned test_tokens()
+{
+    unsigned succeeded = 0;
+
+    // Rendering the tokens gives back the spelling
+    static const unsigned options[] = {CARDINAL, ORDINAL|FEMININE, CARDINAL_AS_ORDINAL, CENT_1100_1999, ORDINAL|CENT_1100_1999, BELGIUM, SWITZERLAND|OCTANTE, ORDINAL|SECOND, ORDINAL_SUFFIX};
+    std::vector<token> tokens;
+    for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+    {
+        for (uintmax_t value = 0; value < 30000u; value += (value < 2000u) ? 1u : 997u)
+        {
+            tokens.clear();
+            spell_tokens(value, options[o], std::back_inserter(tokens));
+            ++g_testCount;
+            if (render(tokens) == spell_out(value, options[o]))
+                ++succeeded;
+            else
+                fprintf(stderr, "%s(%d): the tokens of %" PRIuMAX " with options 0x%X don't render as its spelling\n", __FILE__, __LINE__, value, options[o]);
+        }
+    }
+    tokens.clear();
+    spell_tokens(INTMAX_MIN, CARDINAL, std::back_inserter(tokens));
+    ++g_testCount;
+    succeeded += (render(tokens) == spell_out(INTMAX_MIN));
+    tokens.clear();
+    spell_tokens(UINTMAX_MAX, ORDINAL, std::back_inserter(tokens));
+    ++g_testCount;
+    succeeded += (render(tokens) == spell_out(UINTMAX_MAX, ORDINAL));
+#if RMGR_NSFR_HAS_INT128
+    tokens.clear();
+    spell_tokens(~internal::uint128_t(0), CARDINAL, std::back_inserter(tokens));
+    ++g_testCount;
+    succeeded += (render(tokens) == spell_out(~internal::uint128_t(0)));
+#endif
+
+    // Words, joiners and endings are told apart
+    const token eighty[] = {token::QUATRE, token::JOIN_HYPHEN, token::VINGT, token::PLURAL_S};
+    tokens.clear();
+    spell_tokens(80, CARDINAL, std::back_inserter(tokens));
+    ++g_testCount;
+    succeeded += (tokens == std::vector<token>(eighty, eighty + 4));
+
+    const token seventyOne[] = {token::MOINS, token::JOIN_SPACE, token::SOIXANTE, token::JOIN_ET, token::ONZE};
+    tokens.clear();
+    spell_tokens(-71, CARDINAL, std::back_inserter(tokens));
+    ++g_testCount;
+    succeeded += (tokens == std::vector<token>(seventyOne, seventyOne + 5));
+
+    const token twoMillionth[] = {token::DEUX, token::JOIN_SPACE, token::NUMERAL_MILLION, token::ORDINAL_IEME};
+    token buffer[8];
+    ++g_testCount;
+    succeeded += (spell_tokens(2000000, ORDINAL, buffer) == buffer + 4 && std::equal(buffer, buffer + 4, twoMillionth));
+    ++g_testCount;
+    succeeded += (render(buffer, buffer + 4) == u8"deux millionième" && render(buffer, buffer) == "");
+
+    return succeeded;
+}
+
+
+static unsigned test_segments()
+{
+    unsigned succeeded = 0;
+
+    // Joining the segments gives the spelling
+    static const unsigned options[] = {CARDINAL, ORDINAL|FEMININE, CARDINAL_AS_ORDINAL, CENT_1100_1999, ORDINAL|CENT_1100_1999, BELGIUM, ORDINAL|SECOND, ORDINAL_SUFFIX};
+    spelled_segment segments[64];
+    for (size_t o = 0; o < sizeof(options) / sizeof(options[0]); ++o)
+    {
+        for (uintmax_t value = 0; value < 30000u; value += (value < 2000u) ? 1u : 997u)
+        {
+            const size_t count = to_segments(segments, 64, value, options[o]);
+            std::string joined;
+            for (size_t i = 0; i < count; ++i)
+                joined.append(segments[i].data, segments[i].length);
+            ++g_testCount;
+            if (count <= 64u && joined == spell_out(value, options[o]) && to_segments(nullptr, 0, value, options[o]) == count)
+                ++succeeded;
+            else
+                fprintf(stderr, "%s(%d): the segments of %" PRIuMAX " with options 0x%X don't join into its spelling\n", __FILE__, __LINE__, value, options[o]);
+        }
+    }
+
+    // Segments point to the same static text every time, and nothing is written beyond the capacity
+    const size_t count = to_segments(segments, 64, INTMAX_MIN);
+    std::string joined;
+    for (size_t i = 0; i < count; ++i)
+        joined.append(segments[i].data, segments[i].length);
+    ++g_testCount;
+    succeeded += (joined == spell_out(INTMAX_MIN));
+
+    spelled_segment again[64] = {};
+    ++g_testCount;
+    succeeded += (to_segments(again, 3, INTMAX_MIN) == count && again[2].data == segments[2].data && again[3].data == nullptr);
+
+    return succeeded;
+}
+
+
+/**
+ * @brief Checks the normalization of a text fed at once, in two chunks split anywhere, and byte by byte
+ */
+static bool assert_normalized(int line, const char* text, unsigned options, const char* expected)
+{
+    ++g_testCount;
+    const size_t length = strlen(text);
+    std::string  result = normalize(text, text + length, options);
+    if (result != expected)
+    {
+        fprintf(stderr, "%s(%d): \"%s\" was normalized as \"%s\" instead of \"%s\"\n", __FILE__, line, text, result.c_str(), expected);
+        return false;
+    }
+
+    for (size_t split = 0; split <= length + 1u; ++split)
+    {
+        result.clear();
+        normalizer norm(append_chunk, &result, options);
+        if (split <= length)
+        {
+            norm.feed(text, split);
+            norm.feed(text + split, length - split);
+        }
+        else
+        {
+            for (size_t i = 0; i < length; ++i)
+                norm.feed(text + i, 1);
+        }
+        norm.finish();
+        if (result != expected)
+        {
+            fprintf(stderr, "%s(%d): \"%s\" was normalized as \"%s\" when split at %u\n", __FILE__, line, text, result.c_str(), unsigned(split));
+            return false;
+        }
+    }
+    return true;
+}
+
+#define ASSERT_NORMALIZED(text, options, expected)  succeeded += assert_normalized(__LINE__, text, options, expected)
+
+
+static unsigned test_normalizer()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_NORMALIZED("",                               CARDINAL,  "");
+    ASSERT_NORMALIZED("pas de nombre",                  CARDINAL,  "pas de nombre");
+    ASSERT_NORMALIZED("42",                             CARDINAL,  u8"quarante-deux");
+    ASSERT_NORMALIZED("J'ai 80 ans et 21 jours.",       CARDINAL,  u8"J'ai quatre-vingts ans et vingt et un jours.");
+    ASSERT_NORMALIZED("21 voitures",                    FEMININE,  u8"vingt et une voitures");
+    ASSERT_NORMALIZED("en 1971",                        BELGIUM,   u8"en mille neuf cent septante et un");
+    ASSERT_NORMALIZED("007",                            CARDINAL,  u8"sept");
+
+    // Signs
+    ASSERT_NORMALIZED("-12",                            CARDINAL,  u8"moins douze");
+    ASSERT_NORMALIZED("il fait -3 (-4)",                CARDINAL,  u8"il fait moins trois (moins quatre)");
+    ASSERT_NORMALIZED("10-12 ans",                      CARDINAL,  u8"dix-douze ans");
+    ASSERT_NORMALIZED("A-3",                            CARDINAL,  u8"A-trois");
+    ASSERT_NORMALIZED("a - b -",                        CARDINAL,  "a - b -");
+    ASSERT_NORMALIZED("--5-",                           CARDINAL,  u8"-moins cinq-");
+    ASSERT_NORMALIZED("-0",                             CARDINAL,  u8"zéro");
+
+    // Thousands separators
+    ASSERT_NORMALIZED("1 000 000 d'euros",              CARDINAL,  u8"un million d'euros");
+    ASSERT_NORMALIZED("12\xC2\xA0" "345",               CARDINAL,  u8"douze mille trois cent quarante-cinq");
+    ASSERT_NORMALIZED("-2\xE2\x80\xAF" "000\xE2\x80\xAF" "001", CARDINAL, u8"moins deux millions un");
+    ASSERT_NORMALIZED("entre 1 et 2",                   CARDINAL,  u8"entre un et deux");
+    ASSERT_NORMALIZED("1 0000",                         CARDINAL,  u8"un zéro");
+    ASSERT_NORMALIZED("1 00",                           CARDINAL,  u8"un zéro");
+    ASSERT_NORMALIZED("1 000 00",                       CARDINAL,  u8"mille zéro");
+    ASSERT_NORMALIZED("1234 567",                       CARDINAL,  u8"mille deux cent trente-quatre cinq cent soixante-sept");
+    ASSERT_NORMALIZED("1 000\xC2\xA0" "000",            CARDINAL,  u8"mille\xC2\xA0z\xC3\xA9ro");
+    ASSERT_NORMALIZED("1\xC2\xA1" "000",                CARDINAL,  u8"un\xC2\xA1z\xC3\xA9ro");
+    ASSERT_NORMALIZED("1 ",                             CARDINAL,  "un ");
+    ASSERT_NORMALIZED("2\xE2\x80",                      CARDINAL,  "deux\xE2\x80");
+
+    // Ordinal abbreviations
+    ASSERT_NORMALIZED("le 1er mai",                     CARDINAL,  "le premier mai");
+    ASSERT_NORMALIZED("la 1re, la 1\xC3\xA8re",         CARDINAL,  u8"la première, la première");
+    ASSERT_NORMALIZED("le 2e, le 3\xC3\xA8me, le 4eme", CARDINAL,  u8"le deuxième, le troisième, le quatrième");
+    ASSERT_NORMALIZED("le 5i\xC3\xA8me et le 6ieme",    CARDINAL,  u8"le cinquième et le sixième");
+    ASSERT_NORMALIZED("le 2nd, la 2nde",                CARDINAL,  "le second, la seconde");
+    ASSERT_NORMALIZED("le 1 000e",                      CARDINAL,  u8"le millième");
+    ASSERT_NORMALIZED("le 80e",                         SWITZERLAND, u8"le huitantième");
+    ASSERT_NORMALIZED("le 1er",                         FEMININE,  "le premier");
+    ASSERT_NORMALIZED("1e 2er 3nd 1nde",                CARDINAL,  "une deuxer troisnd unnde");
+    ASSERT_NORMALIZED("3ex 3em 3e5",                    CARDINAL,  "troisex troisem troisecinq");
+    ASSERT_NORMALIZED("-1er",                           CARDINAL,  "moins uner");
+    ASSERT_NORMALIZED("21e\xC3\xA9t\xC3\xA9",           CARDINAL,  u8"vingt et une\xC3\xA9t\xC3\xA9");
+    ASSERT_NORMALIZED("2e.",                            CARDINAL,  u8"deuxième.");
+    ASSERT_NORMALIZED("0e",                             CARDINAL,  u8"zéroième");
+    ASSERT_NORMALIZED("1000000000000000000000000000000000000000e", CARDINAL, u8"sextilliardième");
+
+    // Long texts with digits straddling chunks, whatever their size
+    std::string text;
+    std::string expected;
+    for (unsigned i = 0; i < 2000; ++i)
+    {
+        text     += "Le texte ";
+        expected += "Le texte ";
+        if (i % 7u == 0u)
+        {
+            text     += std::to_string(i * 997u) + "e";
+            expected += spell_out(i * 997u, ORDINAL);
+        }
+        else
+        {
+            text     += "-" + std::to_string(i * 31u);
+            expected += spell_out(-intmax_t(i * 31u));
+        }
+        text     += ", et du texte sans chiffres.\n";
+        expected += ", et du texte sans chiffres.\n";
+    }
+    static const size_t chunkSizes[] = {1, 3, 16, 31, 32, 33, 4096, 1000000};
+    for (size_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++c)
+    {
+        std::string result;
+        normalizer norm(append_chunk, &result);
+        for (size_t i = 0; i < text.size(); i += chunkSizes[c])
+            norm.feed(text.data() + i, std::min(chunkSizes[c], text.size() - i));
+        norm.finish();
+        ++g_testCount;
+        if (result == expected)
+            ++succeeded;
+        else
+            fprintf(stderr, "%s(%d): normalizing in chunks of %u bytes failed\n", __FILE__, __LINE__, unsigned(chunkSizes[c]));
+    }
+
+    return succeeded;
+}
+
+
+/**
+ * @brief Scans a text at once and byte by byte, checking that both find the expected numbers
+ */
+template<typename... Numbers>
+static bool assert_scanned(int line, const char* text, const Numbers&... numbers)
+{
+    ++g_testCount;
+    const std::vector<spelled_number> expected = {numbers...};
+    const size_t                length  = strlen(text);
+    std::vector<spelled_number> results[2];
+    results[0] = scan(text, text + length);
+    scanner reader([](void* context, const spelled_number& number)
+    {
+        static_cast<std::vector<spelled_number>*>(context)->push_back(number);
+    }, &results[1]);
+    for (size_t i = 0; i < length; ++i)
+        reader.feed(text + i, 1);
+    reader.finish();
+
+    for (unsigned r = 0; r < 2u; ++r)
+    {
+        bool same = (results[r].size() == expected.size());
+        for (size_t i = 0; same && i < expected.size(); ++i)
+        {
+            const spelled_number& a = results[r][i];
+            const spelled_number& b = expected[i];
+            same = (a.offset == b.offset && a.length == b.length && a.ec == b.ec && a.value == b.value && a.negative == b.negative && a.options == b.options);
+        }
+        if (!same)
+        {
+            fprintf(stderr, "%s(%d): scanning \"%s\"%s found %u numbers:\n", __FILE__, line, text, (r == 0u) ? "" : " byte by byte", unsigned(results[r].size()));
+            for (size_t i = 0; i < results[r].size(); ++i)
+            {
+                const spelled_number& n = results[r][i];
+                fprintf(stderr, "    at %u, %u bytes: %s%" PRIuMAX " with options 0x%X\n", unsigned(n.offset), unsigned(n.length), n.negative ? "-" : "", n.value, n.options);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+#define ASSERT_SCANNED(...)  succeeded += assert_scanned(__LINE__, __VA_ARGS__)
+
+
+static spelled_number found(uint64_t offset, size_t length, uintmax_t value, unsigned options = CARDINAL, bool negative = false)
+{
+    const spelled_number number = {offset, length, std::errc(), value, negative, options};
+    return number;
+}
+
+
+static unsigned test_scanner()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_SCANNED("");
+    ASSERT_SCANNED("Pas de nombre ici.");
+    ASSERT_SCANNED("Le contrat porte sur deux cent mille euros, en vingt-et-un versements.",
+                   found(21, 15, 200000), found(47, 11, 21));
+    ASSERT_SCANNED(u8"Il fait moins douze degrés", found(8, 11, 12, CARDINAL, true));
+    ASSERT_SCANNED(u8"la troisième fois, la première", found(3, 10, 3, ORDINAL), found(23, 9, 1, ORDINAL | FEMININE));
+    ASSERT_SCANNED("quatre-vingt-dix-sept septante-cinq huitante", found(0, 21, 97), found(22, 13, 75, SEPTANTE), found(36, 8, 80, HUITANTE));
+    ASSERT_SCANNED(u8"DEUX MILLE Zéro ZÉRO", found(0, 10, 2000), found(11, 5, 0), found(17, 5, 0));
+    ASSERT_SCANNED(u8"cinquante-deuxième", found(0, 19, 52, ORDINAL));
+    ASSERT_SCANNED("onze cents", found(0, 10, 1100, CENT_1100_1999));
+
+    // Where numbers end
+    ASSERT_SCANNED("un, deux",          found(0, 2, 1), found(4, 4, 2));
+    ASSERT_SCANNED("vingt  deux",       found(0, 5, 20), found(7, 4, 2));
+    ASSERT_SCANNED("vingt -deux",       found(0, 5, 20), found(7, 4, 2));
+    ASSERT_SCANNED("trois quatre",      found(0, 5, 3), found(6, 6, 4));
+    ASSERT_SCANNED("vingt et cent",     found(0, 5, 20), found(9, 4, 100));
+    ASSERT_SCANNED("vingt et, un",      found(0, 5, 20), found(10, 2, 1));
+    ASSERT_SCANNED("dix moins deux",    found(0, 3, 10), found(4, 10, 2, CARDINAL, true));
+    ASSERT_SCANNED("moins moins un",    found(6, 8, 1, CARDINAL, true));
+    ASSERT_SCANNED("moins, et");
+    ASSERT_SCANNED("l'un d'eux",        found(2, 2, 1));
+    ASSERT_SCANNED(u8"deuxièmement cents-", found(14, 5, 100));
+    ASSERT_SCANNED("mille milliards de milliards", found(0, 5, 1000), found(6, 9, 1000000000), found(19, 9, 1000000000));
+    ASSERT_SCANNED("mille 2 mille2",    found(0, 5, 1000));
+
+    spelled_number tooLarge = found(0, 15, 0);
+    tooLarge.ec = std::errc::result_out_of_range;
+    ASSERT_SCANNED("vingt trillions", tooLarge);
+    tooLarge.length = 185;
+    ASSERT_SCANNED("dix-huit trillions quatre cent quarante-six billiards sept cent quarante-quatre billions soixante-treize milliards "
+                   "sept cent neuf millions cinq cent cinquante et un mille six cent seize", tooLarge); // UINTMAX_MAX + 1
+
+    // Whatever is spelled out is found as a single number, whether words are joined with spaces or hyphens
+    static const unsigned options[] = {CARDINAL, ORDINAL, ORDINAL|FEMININE, CARDINAL|FEMININE, BELGIUM, SWITZERLAND|ORDINAL, CENT_1100_1999};
+    uint64_t seed = 4321;
+    for (unsigned i = 0; i < 3000; ++i)
+    {
+        seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const int64_t  value = int64_t(seed) >> (i % 64u);
+        const unsigned opts  = options[i % (sizeof(options) / sizeof(options[0]))];
+        if (value < 0 && (opts & ORDINAL))
+            continue;
+        std::string spelling = spell_out(value, opts);
+        if (i % 2u != 0u)
+            std::replace(spelling.begin(), spelling.end(), ' ', '-');
+        const parse_result parsed = parse(spelling.data(), spelling.data() + spelling.size());
+        const std::string  text   = "Total : " + spelling + ".";
+        spelled_number     number = found(8, spelling.size(), parsed.value, parsed.options, parsed.negative);
+        ASSERT_SCANNED(text.c_str(), number);
+    }
+
+    return succeeded;
+}
+
+
+static bool assert_check(int line, uintmax_t value, unsigned options, const char* candidate, size_t offset, mismatch reason)
+{
+    ++g_testCount;
+    const char* const  last   = candidate + strlen(candidate);
+    const match_result result = check_spelling(value, options, candidate, last);
+    if (result.offset != offset || result.reason != reason || matches(value, options, candidate, last) != (reason == mismatch::none))
+    {
+        fprintf(stderr, "%s(%d): checking \"%s\" against %" PRIuMAX " gave %u at offset %u instead of %u at offset %u\n",
+                __FILE__, line, candidate, value, unsigned(result.reason), unsigned(result.offset), unsigned(reason), unsigned(offset));
+        return false;
+    }
+    return true;
+}
+
+#define ASSERT_CHECK(value, options, candidate, offset, reason)  succeeded += assert_check(__LINE__, value, options, candidate, offset, mismatch::reason)
+
+
+static unsigned test_validation()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_CHECK(80,      CARDINAL,          "quatre-vingts",       13, none);
+    ASSERT_CHECK(80,      CARDINAL,          "quatre-vingt",        12, missing_plural);
+    ASSERT_CHECK(200,     CARDINAL,          "deux cent",            9, missing_plural);
+    ASSERT_CHECK(201,     CARDINAL,          "deux cents un",        9, extra_plural);
+    ASSERT_CHECK(2000,    CARDINAL,          "deux milles",         10, extra_plural);
+    ASSERT_CHECK(81,      CARDINAL,          "quatre-vingts-un",    12, extra_plural);
+    ASSERT_CHECK(21,      CARDINAL,          "vingt-un",             5, et);
+    ASSERT_CHECK(21,      CARDINAL,          "vingt un",             6, et);
+    ASSERT_CHECK(22,      CARDINAL,          "vingt et deux",        5, et);
+    ASSERT_CHECK(21,      CARDINAL,          "vingt-et-un",          5, joiner);
+    ASSERT_CHECK(80,      CARDINAL,          "quatre vingts",        6, joiner);
+    ASSERT_CHECK(101,     CARDINAL,          "cent-un",              4, joiner);
+    ASSERT_CHECK(21,      CARDINAL,          "vingt et une",        11, gender);
+    ASSERT_CHECK(21,      FEMININE,          "vingt et un",         11, gender);
+    ASSERT_CHECK(1000000, CARDINAL,          "une million",          2, gender);
+    ASSERT_CHECK(1,       ORDINAL,           u8"première",           5, gender);
+    ASSERT_CHECK(1,       ORDINAL|FEMININE,  "premier",              5, gender);
+    ASSERT_CHECK(2,       ORDINAL|SECOND,    "seconde",              6, gender);
+    ASSERT_CHECK(1234,    CARDINAL,          "mille deux cent",     15, truncated);
+    ASSERT_CHECK(1234,    CARDINAL,          "",                     0, truncated);
+    ASSERT_CHECK(12,      CARDINAL,          "douze ans",            5, trailing);
+    ASSERT_CHECK(12,      CARDINAL,          "douse",                3, other);
+    ASSERT_CHECK(2,       ORDINAL,           "deuxieme",             5, other);
+    ASSERT_CHECK(70,      BELGIUM,           "septante",             8, none);
+    ASSERT_CHECK(70,      BELGIUM,           "soixante-dix",         1, other);
+    ASSERT_CHECK(UINT64_MAX, CARDINAL,       "dix-huit trillions",  18, truncated);
+
+    // Negative numbers and the other integer types
+    const char minus80[] = "moins quatre-vingts";
+    ++g_testCount;
+    succeeded += (matches(-80, CARDINAL, minus80, minus80 + strlen(minus80)) && !matches(80, CARDINAL, minus80, minus80 + strlen(minus80)));
+#if RMGR_NSFR_HAS_STRING_VIEW
+    ++g_testCount;
+    succeeded += (matches(-80, CARDINAL, std::string_view("moins quatre-vingts")) && !matches(short(80), CARDINAL, std::string_view("quatre-vingt")));
+#endif
+
+    // Every spelling matches, and only it
+    static const unsigned options[] = {CARDINAL, ORDINAL|FEMININE, CARDINAL_AS_ORDINAL, CENT_1100_1999, SWITZERLAND, ORDINAL|SECOND};
+    uint64_t seed = 99;
+    for (unsigned i = 0; i < 20000; ++i)
+    {
+        seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const int64_t     value    = int64_t(seed) >> (i % 64u);
+        const unsigned    opts     = options[i % (sizeof(options) / sizeof(options[0]))];
+        if (value < 0 && (opts & ORDINAL))
+            continue;
+        const std::string spelling = spell_out(value, opts);
+        const char* const first    = spelling.data();
+        const char* const last     = first + spelling.size();
+        const match_result result  = check_spelling(value, opts, first, last);
+        ++g_testCount;
+        if (matches(value, opts, first, last) && result.reason == mismatch::none && result.offset == spelling.size()
+         && !matches(value, opts, first, last - 1) && !matches(value ^ 1, opts, first, last))
+            ++succeeded;
+        else
+            fprintf(stderr, "%s(%d): \"%s\" was not matched against %" PRId64 " with options 0x%X\n", __FILE__, __LINE__, spelling.c_str(), value, opts);
+    }
+
+    return succeeded;
+}
+
+
+static bool assert_completed(int line, unsigned options, const char* prefix, const std::vector<value_range>& values, const std::vector<std::string>& words)
+{
+    ++g_testCount;
+    const completions result = completion_index(options).lookup(prefix, prefix + strlen(prefix));
+    bool same = (result.values.size() == values.size() && result.words == words);
+    for (size_t i = 0; same && i < values.size(); ++i)
+        same = (result.values[i].first == values[i].first && result.values[i].last == values[i].last);
+    if (!same)
+    {
+        fprintf(stderr, "%s(%d): completing \"%s\" with options 0x%X gave", __FILE__, line, prefix, options);
+        for (const value_range& range : result.values)
+            fprintf(stderr, " [%" PRIuMAX ";%" PRIuMAX "]", range.first, range.last);
+        for (const std::string& word : result.words)
+            fprintf(stderr, " \"%s\"", word.c_str());
+        fprintf(stderr, "\n");
+        return false;
+    }
+    return true;
+}
+
+#define ASSERT_COMPLETED(options, prefix, values, words)  succeeded += assert_completed(__LINE__, options, prefix, std::vector<value_range> values, std::vector<std::string> words)
+
+
+static unsigned test_completion()
+{
+    unsigned succeeded = 0;
+
+    ASSERT_COMPLETED(CARDINAL,            "xyz",                   ({}),                                           ({}));
+    ASSERT_COMPLETED(CARDINAL,            u8"zé",                  ({{0, 0}}),                                     ({u8"zéro"}));
+    ASSERT_COMPLETED(ORDINAL,             "premi",                 ({{1, 1}}),                                     ({"premier"}));
+    ASSERT_COMPLETED(ORDINAL|FEMININE,    "premi",                 ({{1, 1}}),                                     ({u8"première"}));
+    ASSERT_COMPLETED(ORDINAL,             "deuxi",                 ({{2, 2}}),                                     ({u8"deuxième"}));
+    ASSERT_COMPLETED(ORDINAL|SECOND,      "deuxi",                 ({}),                                           ({}));
+    ASSERT_COMPLETED(CARDINAL,            "dix-huit tr",           ({{UINT64_C(18000000000000000000), UINT64_MAX}}), ({"trillions"}));
+    ASSERT_COMPLETED(CARDINAL,            "mille mi",              ({}),                                           ({}));
+    ASSERT_COMPLETED(CARDINAL,            "deux cent mille un",    ({{200001, 200001}}),                           ({"un"}));
+    ASSERT_COMPLETED(CARDINAL,            "quatre-vingt",          ({{80, 99}, {80000, 99999}, {80000000, 99999999}, {UINT64_C(80000000000), UINT64_C(99999999999)},
+                                                                     {UINT64_C(80000000000000), UINT64_C(99999999999999)}, {UINT64_C(80000000000000000), UINT64_C(99999999999999999)}}),
+                                                                    ({"vingt", "vingts"}));
+    ASSERT_COMPLETED(ORDINAL,             "mille d",               ({{1002, 1002}, {1010, 1010}, {1012, 1012}, {1017, 1019}, {1200, 1299}}),
+                                                                    ({"deux", u8"deuxième", "dix", u8"dixième", u8"douzième"}));
+    ASSERT_COMPLETED(ORDINAL,             "deux million",          ({{2000000, 2999999}}),                         ({u8"millionième", "millions"}));
+    ASSERT_COMPLETED(CARDINAL,            "un million et",         ({}),                                           ({}));
+    ASSERT_COMPLETED(CENT_1100_1999,      "onze c",                ({{1100, 1199}}),                               ({"cent", "cents"}));
+    ASSERT_COMPLETED(CENT_1100_1999,      "mille cent",            ({}),                                           ({}));
+    ASSERT_COMPLETED(CENT_1100_1999,      "un million mille c",    ({{1001005, 1001005}, {1001050, 1001059}}),    ({"cinq", "cinquante"}));
+    ASSERT_COMPLETED(BELGIUM,             "septante-n",            ({{79, 79}, {79000, 79999}, {79000000, 79999999}, {UINT64_C(79000000000), UINT64_C(79999999999)},
+                                                                     {UINT64_C(79000000000000), UINT64_C(79999999999999)}, {UINT64_C(79000000000000000), UINT64_C(79999999999999999)}}),
+                                                                    ({"neuf"}));
+    ASSERT_COMPLETED(SWITZERLAND|ORDINAL, "cent huitante-d",       ({{182, 182}, {182000, 182999}, {182000000, 182999999}, {UINT64_C(182000000000), UINT64_C(182999999999)},
+                                                                     {UINT64_C(182000000000000), UINT64_C(182999999999999)}, {UINT64_C(182000000000000000), UINT64_C(182999999999999999)}}),
+                                                                    ({"deux", u8"deuxième"}));
+    ASSERT_COMPLETED(CARDINAL,            "",                      ({{0, UINT64_MAX}}),
+                                                                    ({"cent", "cinq", "cinquante", "deux", "dix", "douze", "huit", "mille", "neuf", "onze", "quarante", "quatorze",
+                                                                     "quatre", "quinze", "seize", "sept", "six", "soixante", "treize", "trente", "trois", "un", "vingt", u8"zéro"}));
+
+    // Completing any beginning of a spelling gives the number, only numbers spelled out alike, and the word that follows
+    static const unsigned options[] = {CARDINAL, ORDINAL, ORDINAL|FEMININE|SECOND, CARDINAL_AS_ORDINAL|FEMININE, CENT_1100_1999, BELGIUM|ORDINAL, SWITZERLAND};
+    const size_t optionCount = sizeof(options) / sizeof(options[0]);
+    std::vector<std::unique_ptr<completion_index>> indexes;
+    for (size_t o = 0; o < optionCount; ++o)
+        indexes.emplace_back(new completion_index(options[o]));
+    completions result;
+    uint64_t seed = 2024;
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const uint64_t    value    = seed >> (i % 64u);
+        const unsigned    opts     = options[i % optionCount];
+        const std::string spelling = spell_out(value, opts);
+        const size_t      length   = size_t(seed >> 32) % (spelling.size() + 1u);
+        indexes[i % optionCount]->lookup(spelling.data(), spelling.data() + length, result);
+
+        size_t wordBegin = spelling.find_last_of(" -", length == 0u ? std::string::npos : length - 1u);
+        wordBegin = (wordBegin == std::string::npos || length == 0u) ? 0u : wordBegin + 1u;
+        size_t wordEnd = spelling.find_first_of(" -", length);
+        wordEnd = (wordEnd == std::string::npos) ? spelling.size() : wordEnd;
+        const std::string word = spelling.substr(wordBegin, wordEnd - wordBegin);
+
+        bool found = std::find(result.words.begin(), result.words.end(), word) != result.words.end();
+        bool valid = found;
+        for (size_t r = 0; r < result.values.size(); ++r)
+        {
+            const value_range& range = result.values[r];
+            if (range.first <= value && value <= range.last)
+                found = true;
+            if (range.first > range.last || (r != 0u && result.values[r-1].last + 1u >= range.first))
+                valid = false;
+            const uint64_t samples[] = {range.first, range.last, range.first + (range.last - range.first) / 3u};
+            for (uint64_t sample : samples)
+                if (spell_out(sample, opts).compare(0, length, spelling, 0, length) != 0)
+                    valid = false;
+        }
+
+        ++g_testCount;
+        if (found && valid)
+            ++succeeded;
+        else
+            fprintf(stderr, "%s(%d): completing \"%s\" with options 0x%X misses %" PRIu64 " or gives wrong values\n", __FILE__, __LINE__, spelling.substr(0, length).c_str(), opts, value);
+    }
+
+    return succeeded;
+}
+
+
+/**
+ * @brief Reference collation: spellings are compared with their accented letters and hyphens
+ *        folded, then as they are
+ */
+static int collate_reference(const std::string& a, const std::string& b)
+{
+    const auto fold = [](const std::string& str)
+    {
+        std::string folded;
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            if (str.compare(i, 2, u8"é") == 0 || str.compare(i, 2, u8"è") == 0)
+            {
+                folded += 'e';
+                ++i;
+            }
+            else
+                folded += (str[i] == '-') ? ' ' : str[i];
+        }
+        return folded;
+    };
+    const int order = fold(a).compare(fold(b));
+    return (order != 0) ? order : a.compare(b);
+}
+
+
+static bool assert_collated(int line, uint64_t a, uint64_t b, unsigned options)
+{
+    ++g_testCount;
+    const std::string spellingA = spell_out(a, options);
+    const std::string spellingB = spell_out(b, options);
+    const int         expected  = collate_reference(spellingA, spellingB);
+    const int         order     = compare_spelled(a, b, options);
+    const uint64_t    keyA      = spelled_sort_key(a, options);
+    const uint64_t    keyB      = spelled_sort_key(b, options);
+    if ((order < 0) == (expected < 0) && (order > 0) == (expected > 0)
+     && (keyA == keyB || (keyA < keyB) == (order < 0)) && (keyA <= keyB || order > 0))
+        return true;
+    fprintf(stderr, "%s(%d): comparing \"%s\" with \"%s\" gave %d, keys 0x%" PRIX64 " and 0x%" PRIX64 "\n",
+            __FILE__, line, spellingA.c_str(), spellingB.c_str(), order, keyA, keyB);
+    return false;
+}
+
+#define ASSERT_COLLATED(a, b, options)  succeeded += assert_collated(__LINE__, a, b, options)
+
+
+static unsigned test_collation()
+{
+    unsigned succeeded = 0;
+
+    ++g_testCount;
+    succeeded += (compare_spelled(2, 10) < 0 && compare_spelled(10, 2) > 0 && compare_spelled(7, 7) == 0 && compare_spelled(-1, 1) < 0);
+    ++g_testCount;
+    succeeded += (compare_spelled(1000, 1000000, ORDINAL) < 0); // "millième" before "millionième", unlike their bytes
+    ++g_testCount;
+    succeeded += (compare_spelled(6, 600) < 0 && compare_spelled(600, 606) > 0); // "six", "six cent six", "six cents"
+    ++g_testCount;
+    succeeded += (spelled_sort_key(1) < spelled_sort_key(0) && spelled_sort_key(short(70), BELGIUM) == spelled_sort_key(70, BELGIUM)); // "un" before "zéro"
+#if RMGR_NSFR_HAS_INT128
+    ++g_testCount;
+    succeeded += (compare_spelled(internal::int128_t(-5), internal::int128_t(5)) > 0 && compare_spelled(internal::uint128_t(UINT64_MAX) * 1000u, internal::uint128_t(3)) < 0); // "moins cinq" after "cinq"
+#endif
+
+    ASSERT_COLLATED(1000, 1000000, ORDINAL);
+    ASSERT_COLLATED(1000001, 1001, ORDINAL|FEMININE);
+    ASSERT_COLLATED(21, 2000, CARDINAL);
+    ASSERT_COLLATED(200, 201, CARDINAL);
+    ASSERT_COLLATED(81, 80, CARDINAL_AS_ORDINAL);
+    ASSERT_COLLATED(1, 2, ORDINAL|SECOND);
+
+    // Random pairs agree with the reference collation, and their keys with their order
+    static const unsigned options[] = {CARDINAL, ORDINAL, ORDINAL|FEMININE|SECOND, CARDINAL_AS_ORDINAL, CENT_1100_1999, SWITZERLAND, BELGIUM|ORDINAL};
+    uint64_t seed = 25;
+    for (unsigned i = 0; i < 20000; ++i)
+    {
+        seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const uint64_t a = seed >> (i % 64u);
+        seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+        const uint64_t b = (i % 3u == 0u) ? a + (seed % 16u) : seed >> (i % 61u);
+        ASSERT_COLLATED(a, b, options[i % (sizeof(options) / sizeof(options[0]))]);
+    }
+
+    // Sorting by key then by spelling gives the order of the spellings
+    std::vector<unsigned> sorted;
+    for (unsigned value = 0; value < 3000; ++value)
+        sorted.push_back(value);
+    std::sort(sorted.begin(), sorted.end(), [](unsigned a, unsigned b)
+    {
+        const uint64_t keyA = spelled_sort_key(a, ORDINAL);
+        const uint64_t keyB = spelled_sort_key(b, ORDINAL);
+        return (keyA != keyB) ? keyA < keyB : compare_spelled(a, b, ORDINAL) < 0;
+    });
+    ++g_testCount;
+    bool ordered = true;
+    for (size_t i = 1; i < sorted.size(); ++i)
+        ordered = ordered && collate_reference(spell_out(sorted[i-1], ORDINAL), spell_out(sorted[i], ORDINAL)) < 0;
+    succeeded += ordered;
+
+    return succeeded;
+}
+
+
 int main()
 {
     unsigned succeeded = 0;
     succeeded += test_cardinals();
     succeeded += test_cardinals_as_ordinals();
     succeeded += test_ordinals();
+    succeeded += test_spelled_lengths();
+    succeeded += test_batches();
+    succeeded += test_group_tables();
+    succeeded += test_profiles();
+#if RMGR_NSFR_HAS_INT128
+    succeeded += test_int128();
+#endif
+    succeeded += test_parse();
+    succeeded += test_decimal();
+    succeeded += test_fixed();
+    succeeded += test_amounts();
+    succeeded += test_counters();
+    succeeded += test_caches();
+    succeeded += test_dictionaries();
+    succeeded += test_tokens();
+    succeeded += test_segments();
+    succeeded += test_normalizer();
+    succeeded += test_scanner();
+    succeeded += test_validation();
+    succeeded += test_completion();
+    succeeded += test_collation();
 
     printf("Passed %u/%u tests\n", succeeded, g_testCount);
     return (succeeded == g_testCount) ? EXIT_SUCCESS : EXIT_FAILURE;
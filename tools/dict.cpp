@@ -0,0 +1,176 @@
+/*
+ * This software is available under 2 licenses -- choose whichever you prefer.
+ *
+ * -------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2023 Romain BAILLY
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * -------------------------------------------------------------------------------
+ *
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * For more information, please refer to <https://unlicense.org/>
+ */
+
+#include <rmgr/nsfr.h>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+
+using namespace rmgr::nsfr;
+
+
+//=================================================================================================
+// Options
+
+struct OptionName
+{
+    const char* name;
+    unsigned    value;
+};
+
+static const OptionName g_optionNames[] =
+{
+    {"MASCULINE",           MASCULINE},
+    {"FEMININE",            FEMININE},
+    {"CARDINAL",            CARDINAL},
+    {"ORDINAL",             ORDINAL},
+    {"CARDINAL_AS_ORDINAL", CARDINAL_AS_ORDINAL},
+    {"SECOND",              SECOND},
+    {"SEPTANTE",            SEPTANTE},
+    {"HUITANTE",            HUITANTE},
+    {"OCTANTE",             OCTANTE},
+    {"NONANTE",             NONANTE},
+    {"CENT_1100_1999",      CENT_1100_1999},
+    {"FRANCE",              FRANCE},
+    {"BELGIUM",             BELGIUM},
+    {"SWITZERLAND",         SWITZERLAND},
+};
+
+
+/**
+ * @brief Parses options such as "ORDINAL|FEMININE" or "0x3"
+ */
+static bool parse_options(const char* str, unsigned& options)
+{
+    options = 0;
+    for (;;)
+    {
+        const char*  end    = strchr(str, '|');
+        const size_t length = (end != nullptr) ? size_t(end - str) : strlen(str);
+
+        bool found = false;
+        for (size_t i = 0; i < sizeof(g_optionNames) / sizeof(g_optionNames[0]) && !found; ++i)
+        {
+            if (strlen(g_optionNames[i].name) == length && strncmp(g_optionNames[i].name, str, length) == 0)
+            {
+                options |= g_optionNames[i].value;
+                found    = true;
+            }
+        }
+        if (!found)
+        {
+            char* numberEnd = nullptr;
+            const unsigned long value = strtoul(str, &numberEnd, 0);
+            if (numberEnd != str + length || length == 0)
+                return false;
+            options |= unsigned(value);
+        }
+
+        if (end == nullptr)
+            return true;
+        str = end + 1;
+    }
+}
+
+
+//=================================================================================================
+// Main
+
+static void print_usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s OUTPUT [--count N] [OPTIONS...]\n"
+                    "Writes the spellings of [0; N) (N defaults to 1000001) for each set of options, such as\n"
+                    "CARDINAL, ORDINAL|FEMININE or BELGIUM, into a dictionary file (CARDINAL if none is given).\n", program);
+}
+
+
+int main(int argc, char* argv[])
+{
+    const char*           output = nullptr;
+    uintmax_t             count  = 1000001;
+    std::vector<unsigned> profiles;
+    for (int i = 1; i < argc; ++i)
+    {
+        unsigned options = 0;
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = strtoumax(argv[++i], nullptr, 10);
+        else if (output == nullptr && argv[i][0] != '-')
+            output = argv[i];
+        else if (parse_options(argv[i], options))
+            profiles.push_back(options);
+        else
+        {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (output == nullptr)
+    {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (profiles.empty())
+        profiles.push_back(CARDINAL);
+
+    const std::errc ec = write_dictionary(output, count, profiles.data(), profiles.size());
+    if (ec != std::errc())
+    {
+        fprintf(stderr, "%s: %s\n", output, std::make_error_code(ec).message().c_str());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}